@@ -0,0 +1,75 @@
+'''
+Throughput of json_autocomplete() from several threads sharing the same grammar.
+On free-threaded CPython (3.13t and later, run with PYTHON_GIL=0) it should scale with the number of threads, since the grammar is immutable and all parse state is per call; with the GIL it stays flat.
+
+    python benchmarks/threads.py [max_threads] [seconds]
+'''
+
+
+import json
+import os
+import sys
+import threading
+import time
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), '..'))
+from json_autocomplete import json_autocomplete
+
+
+DOCUMENT = json.dumps({
+    'name': 'get_weather',
+    'arguments': {
+        'location': {'city': 'Seoul', 'country': 'KR', 'coordinates': [37.5665, 126.978]},
+        'units': 'metric',
+        'days': 7,
+        'include': ['hourly', 'alerts', 'air_quality'],
+        'note': 'The quick brown fox jumps over the lazy dog. ' * 4,
+    },
+}, indent=2)
+PREFIXES = [DOCUMENT[:i] for i in range(0, len(DOCUMENT), 7)]
+
+
+def run(threads, seconds):
+    '''Returns the number of prefixes completed per second by `threads` threads together.'''
+    start = threading.Barrier(threads + 1)
+    stop = threading.Event()
+    counts = [0] * threads
+
+    def worker(index):
+        start.wait()
+        n = 0
+        while not stop.is_set():
+            for prefix in PREFIXES:
+                json_autocomplete(prefix)
+            n += len(PREFIXES)
+        counts[index] = n
+
+    workers = [threading.Thread(target=worker, args=(i,)) for i in range(threads)]
+    for w in workers:
+        w.start()
+    start.wait()
+    began = time.perf_counter()
+    time.sleep(seconds)
+    stop.set()
+    for w in workers:
+        w.join()
+    return sum(counts) / (time.perf_counter() - began)
+
+
+def main():
+    max_threads = int(sys.argv[1]) if len(sys.argv) > 1 else os.cpu_count()
+    seconds = float(sys.argv[2]) if len(sys.argv) > 2 else 2.0
+    gil = getattr(sys, '_is_gil_enabled', lambda: True)()
+    print(f'Python {sys.version.split()[0]}, GIL {"enabled" if gil else "disabled"}, {len(PREFIXES)} prefixes of a {len(DOCUMENT)} char document')
+
+    threads = 1
+    base = None
+    while threads <= max_threads:
+        rate = run(threads, seconds)
+        base = base or rate
+        print(f'{threads:3d} threads: {rate:12,.0f} prefixes/s  ({rate / base:.2f}x)')
+        threads *= 2
+
+
+if __name__ == '__main__':
+    main()
@@ -1 +1,11 @@
-from .json import json_autocomplete
\ No newline at end of file
+from .arrays import NumericArrays
+from .fingerprint import RunningHash
+from .grammar import compile_grammar
+from .incremental import Completer, Handler, KeyTable, SHARED_KEYS
+from .json import json_autocomplete
+from .lazy import loads_partial_lazy
+from .materialize import Builder, json_default, loads_partial, Rope, to_plain
+from .native import complete_into, complete_many, decode_number, decode_numbers, feed_many, Stream
+from .sinks import Sink
+from .transcode import MessagePackWriter
+from .writer import Writer
\ No newline at end of file
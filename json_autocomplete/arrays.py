@@ -0,0 +1,81 @@
+'''
+Numeric arrays streamed into contiguous typed buffers.
+Large vectors in a streamed document (embeddings, coordinates, samples) would otherwise become a list of float objects, one allocation each, only to be copied into numpy or a tensor afterwards.
+NumericArrays is a Handler for incremental.Completer that appends the numbers of the arrays at chosen paths straight to an array('d'), so the vector received so far can be read at any point.
+'''
+
+
+from array import array
+
+from .incremental import Handler
+from .native import extend_numbers
+from .paths import PathSet, parse_path, path_matches
+
+
+class NumericArrays(Handler):
+    '''Collects the numbers of the arrays at the given paths (patterns, see paths.py) into array('d') buffers, one per matching array, keyed by its concrete path.
+    The buffers support the buffer protocol, so e.g. numpy.frombuffer(arrays['embedding']) views the floats without copying; a buffer cannot grow while such a view exists, so drop it before feeding more.
+    Elements that are not numbers are skipped.
+    Numbers that arrive one at a time (e.g. split across chunks) are decoded in batches, with the next run of numbers, when their array ends, or when the buffer is read through [].'''
+    def __init__(self, paths):
+        self.paths = PathSet(paths)
+        self.arrays = {}
+        self._targets = [] # per open container, its buffer if it is a selected array, else None
+        self._pending = [] # texts of single numbers not decoded yet, all for _pending_buffer
+        self._pending_buffer = None
+
+    def __getitem__(self, path):
+        '''The buffer of the array at `path`, or of the first one matching it, if it is a pattern.'''
+        self._flush()
+        path = parse_path(path)
+        if path in self.arrays:
+            return self.arrays[path]
+        for concrete, buffer in self.arrays.items():
+            if path_matches(path, concrete):
+                return buffer
+        raise KeyError(path)
+
+    def __contains__(self, path):
+        try:
+            self[path]
+        except KeyError:
+            return False
+        return True
+
+    def _flush(self):
+        if self._pending:
+            extend_numbers(self._pending_buffer, ','.join(self._pending), len(self._pending))
+            self._pending = []
+
+    def start_object(self, path):
+        self._targets.append(None)
+
+    def start_array(self, path):
+        buffer = None
+        if self.paths.match(path):
+            buffer = self.arrays[tuple(path)] = array('d')
+        self._targets.append(buffer)
+
+    def end_object(self, path):
+        if self._targets.pop() is self._pending_buffer:
+            self._flush()
+
+    end_array = end_object
+
+    def number(self, path, text):
+        buffer = self._targets[-1] if self._targets else None
+        if buffer is not None:
+            if buffer is not self._pending_buffer:
+                self._flush()
+                self._pending_buffer = buffer
+            self._pending.append(text)
+
+    def numbers(self, path, text):
+        buffer = self._targets[-1]
+        if buffer is not None:
+            count = text.count(',')
+            if self._pending and buffer is self._pending_buffer:
+                count += len(self._pending)
+                text = ','.join(self._pending) + ',' + text
+                self._pending = []
+            extend_numbers(buffer, text, count)
@@ -0,0 +1,30 @@
+'''
+Fingerprints of streamed documents.
+The output of a stream (the fed text itself, or what a compact, pretty-printing or rewriting pass returns from feed()) is never taken back once produced, so it can be hashed incrementally as it grows.
+The fingerprint of the current completion then costs one hash of the suffix, O(depth), instead of hashing the whole completed text on every update.
+'''
+
+
+import hashlib
+
+
+class RunningHash:
+    '''A hash (any hashlib algorithm, BLAKE2b by default) of the stable output so far. fingerprint(suffix) is the hex digest of that output followed by `suffix`,
+    i.e. exactly hashlib.new(name, completed.encode()).hexdigest() for the completed text.'''
+    def __init__(self, name='blake2b', **params):
+        self.name = name
+        self.params = params
+        self.reset()
+
+    def reset(self):
+        self._hash = hashlib.new(self.name, **self.params)
+
+    def update(self, text):
+        self._hash.update(text.encode('utf-8', 'surrogatepass') if isinstance(text, str) else text)
+
+    def fingerprint(self, suffix='') -> str:
+        if not suffix:
+            return self._hash.hexdigest()
+        completed = self._hash.copy()
+        completed.update(suffix.encode('utf-8', 'surrogatepass'))
+        return completed.hexdigest()
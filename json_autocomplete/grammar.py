@@ -0,0 +1,409 @@
+'''
+Text grammars for the auto-filling parsers of parser.py.
+Instead of nesting Seq / Or / Rep objects by hand (as json.py does), a grammar can be written as text, in a small EBNF / PEG style notation:
+
+    value  = 'null' | string | number | object | array | 'true' | 'false' ;
+    digits = [0-9]+ ;
+    string = '"' ( [^"\\] | '\\' escape )* '"' ;   # comment
+
+A rule is `name = expression ;`. Expressions are alternatives separated by `|` (Or), of sequences (Seq) of items, where an item is a 'literal' or "literal" (Lit), a character class (`[a-z]` Range, `[abc]` Any, `[^abc]` Except, or a mix like `[0-9a-f]`), a rule name, or a (group), each optionally followed by `?` (Opt), `*` (Rep) or `+` (one or more).
+The same rules about look-ahead as in json.py apply: the branch to take must always be determined by the next character alone.
+The minimal length of recursive rules, which parser.py needs, is computed from the grammar.
+
+build() turns a grammar into parser.py objects. compile_grammar() turns it into Python source with one function per rule, which runs the same algorithm without the object graph and its dynamic dispatch, and caches the compiled code on disk, keyed by the hash of the grammar, so that loading a known grammar is only a file read.
+'''
+
+
+import hashlib
+import marshal
+import os
+import sys
+
+from .parser import Any, Except, Lit, Opt, Or, Range, Reference, Rep, Seq
+
+
+_VERSION = '1' # of the generated code; part of the cache key
+_ESCAPES = {'n': '\n', 'r': '\r', 't': '\t', '0': '\0'}
+_INFINITE = float('inf')
+
+
+# Parsing the notation, to tuples: ('lit', text), ('range', lo, hi), ('any', chars), ('except', chars), ('ref', name), ('opt', node), ('rep', node), ('or', nodes), ('seq', nodes)
+
+class GrammarError(ValueError):
+    pass
+
+
+class _Reader:
+    def __init__(self, text):
+        self.text = text
+        self.pos = 0
+
+    def fail(self, message):
+        line = self.text.count('\n', 0, self.pos) + 1
+        raise GrammarError(f'line {line}: {message}')
+
+    def skip(self):
+        text = self.text
+        while self.pos < len(text):
+            if text[self.pos] in ' \t\r\n':
+                self.pos += 1
+            elif text[self.pos] == '#':
+                end = text.find('\n', self.pos)
+                self.pos = len(text) if end < 0 else end
+            else:
+                break
+
+    def peek(self):
+        self.skip()
+        return self.text[self.pos] if self.pos < len(self.text) else ''
+
+    def expect(self, char):
+        if self.peek() != char:
+            self.fail(f'expected {char!r}')
+        self.pos += 1
+
+    def name(self):
+        self.skip()
+        start = self.pos
+        while self.pos < len(self.text) and (self.text[self.pos].isalnum() or self.text[self.pos] == '_'):
+            self.pos += 1
+        if start == self.pos:
+            self.fail('expected a rule name')
+        return self.text[start:self.pos]
+
+    def char(self):
+        '''One character of a literal or class, with escapes.'''
+        if self.pos >= len(self.text):
+            self.fail('unexpected end of grammar')
+        c = self.text[self.pos]
+        self.pos += 1
+        if c != '\\':
+            return c
+        if self.pos >= len(self.text):
+            self.fail('unexpected end of grammar in an escape')
+        c = self.text[self.pos]
+        self.pos += 1
+        if c == 'u':
+            digits = self.text[self.pos:self.pos + 4]
+            if len(digits) < 4 or any(d not in '0123456789abcdefABCDEF' for d in digits):
+                self.fail('expected 4 hex digits after \\u')
+            c = chr(int(digits, 16))
+            self.pos += 4
+        return _ESCAPES.get(c, c)
+
+    def rules(self):
+        rules = {}
+        while self.peek():
+            name = self.name()
+            if name in rules:
+                self.fail(f'rule {name!r} is defined twice')
+            self.expect('=')
+            rules[name] = self.alternatives()
+            self.expect(';')
+        if not rules:
+            self.fail('the grammar has no rules')
+        return rules
+
+    def alternatives(self):
+        options = [self.sequence()]
+        while self.peek() == '|':
+            self.pos += 1
+            options.append(self.sequence())
+        return options[0] if len(options) == 1 else ('or', options)
+
+    def sequence(self):
+        items = []
+        while self.peek() not in ('', '|', ')', ';'):
+            items.append(self.item())
+        if not items:
+            self.fail('empty sequence')
+        return items[0] if len(items) == 1 else ('seq', items)
+
+    def item(self):
+        c = self.peek()
+        if c == '(':
+            self.pos += 1
+            node = self.alternatives()
+            self.expect(')')
+        elif c in ('"', "'"):
+            self.pos += 1
+            text = ''
+            while self.pos < len(self.text) and self.text[self.pos] != c:
+                text += self.char()
+            self.expect(c)
+            if not text:
+                self.fail('empty literal')
+            node = ('lit', text)
+        elif c == '[':
+            self.pos += 1
+            node = self.char_class()
+        else:
+            node = ('ref', self.name())
+        while self.pos < len(self.text) and self.text[self.pos] in '?*+':
+            op = self.text[self.pos]
+            self.pos += 1
+            node = ('opt', node) if op == '?' else ('rep', node) if op == '*' else ('seq', [node, ('rep', node)])
+        return node
+
+    def char_class(self):
+        negated = self.pos < len(self.text) and self.text[self.pos] == '^'
+        if negated:
+            self.pos += 1
+        chars, ranges = '', []
+        while self.pos < len(self.text) and self.text[self.pos] != ']':
+            c = self.char()
+            if self.pos + 1 < len(self.text) and self.text[self.pos] == '-' and self.text[self.pos + 1] != ']':
+                self.pos += 1
+                ranges.append(('range', c, self.char()))
+            else:
+                chars += c
+        self.expect(']')
+        if negated:
+            if ranges:
+                self.fail('ranges are not supported in negated classes')
+            return ('except', chars)
+        options = ranges + ([('any', chars)] if chars else [])
+        if not options:
+            self.fail('empty character class')
+        return options[0] if len(options) == 1 else ('or', options)
+
+
+def parse_grammar(text):
+    '''Parse a grammar to {rule name: syntax tree}, in the order of the text.'''
+    rules = _Reader(text).rules()
+    for name, node in rules.items():
+        for ref in _refs(node):
+            if ref not in rules:
+                raise GrammarError(f'rule {name!r} refers to undefined rule {ref!r}')
+    return rules
+
+def _refs(node):
+    kind = node[0]
+    if kind == 'ref':
+        yield node[1]
+    elif kind in ('opt', 'rep'):
+        yield from _refs(node[1])
+    elif kind in ('or', 'seq'):
+        for child in node[1]:
+            yield from _refs(child)
+
+def _min_len(node, lengths):
+    kind = node[0]
+    if kind == 'lit':
+        return len(node[1])
+    if kind in ('range', 'any', 'except'):
+        return 1
+    if kind == 'ref':
+        return lengths[node[1]]
+    if kind in ('opt', 'rep'):
+        return 0
+    if kind == 'or':
+        return min(_min_len(child, lengths) for child in node[1])
+    return sum(_min_len(child, lengths) for child in node[1])
+
+def min_lengths(rules):
+    '''The minimal length of every rule, as a fixpoint, which also covers recursive rules.'''
+    lengths = dict.fromkeys(rules, _INFINITE)
+    changed = True
+    while changed:
+        changed = False
+        for name, node in rules.items():
+            length = _min_len(node, lengths)
+            if length < lengths[name]:
+                lengths[name] = length
+                changed = True
+    for name, length in lengths.items():
+        if length == _INFINITE:
+            raise GrammarError(f'rule {name!r} never ends')
+    return lengths
+
+
+# Building parser.py objects
+
+def build(text):
+    '''Build the parsers of a grammar. Returns {rule name: Reference}, which can be used like any other parser.'''
+    rules = parse_grammar(text)
+    lengths = min_lengths(rules)
+    parsers = {name: Reference(min_len=lengths[name]) for name in rules}
+    for name, node in rules.items():
+        parsers[name].define(_build(node, parsers))
+    return parsers
+
+def _build(node, parsers):
+    kind = node[0]
+    if kind == 'lit':
+        return Lit(node[1])
+    if kind == 'range':
+        return Range(node[1], node[2])
+    if kind == 'any':
+        return Any(node[1])
+    if kind == 'except':
+        return Except(node[1])
+    if kind == 'ref':
+        return parsers[node[1]]
+    if kind == 'opt':
+        return Opt(_build(node[1], parsers))
+    if kind == 'rep':
+        return Rep(_build(node[1], parsers))
+    children = [_build(child, parsers) for child in node[1]]
+    return Or(*children) if kind == 'or' else Seq(*children)
+
+
+# Compiling to Python source: p_<i>(prefix, pos) completes rule i as its parser would, m_<i>(c) is its matches()
+
+class _Generator:
+    def __init__(self, rules):
+        self.rules = rules
+        self.lengths = min_lengths(rules)
+        self.index = {name: i for i, name in enumerate(rules)}
+
+    def source(self):
+        lines = ['# Generated by json_autocomplete.grammar, do not edit.', '']
+        for name, node in self.rules.items():
+            i = self.index[name]
+            lines += ['', f'def m_{i}(c): # {name}', f'    return {self.matches(node)}', '']
+            lines += [f'def p_{i}(prefix, pos): # {name}']
+            lines += self.statements(node, '    ')
+            lines += ['    return prefix, pos', '']
+        lines += ['', 'RULES = {' + ', '.join(f'{name!r}: p_{i}' for name, i in self.index.items()) + '}']
+        return '\n'.join(lines) + '\n'
+
+    def matches(self, node):
+        '''A Python expression for node.matches(c), c being a character.'''
+        kind = node[0]
+        if kind == 'lit':
+            return f'c == {node[1][0]!r}'
+        if kind == 'range':
+            return f'{node[1]!r} <= c <= {node[2]!r}'
+        if kind == 'any':
+            return f'c in {"".join(sorted(set(node[1])))!r}'
+        if kind == 'except':
+            return f'c not in {"".join(sorted(set(node[1])))!r}' if node[1] else 'True'
+        if kind == 'ref':
+            return f'm_{self.index[node[1]]}(c)'
+        if kind == 'opt':
+            return self.matches(node[1])
+        if kind == 'rep':
+            return 'True'
+        if kind == 'or':
+            return '(' + ' or '.join(self.matches(child) for child in node[1]) + ')'
+        # seq: the first child that matches or cannot be skipped decides
+        terms = []
+        for child in node[1]:
+            terms.append(self.matches(child))
+            if _min_len(child, self.lengths) > 0:
+                break
+        else:
+            terms.append('False')
+        return '(' + ' or '.join(terms) + ')'
+
+    def statements(self, node, indent):
+        '''Python statements that run node(prefix, pos) on the locals prefix and pos.'''
+        kind = node[0]
+        if kind == 'lit':
+            text = node[1]
+            if len(text) == 1:
+                return [f'{indent}if pos >= len(prefix):', f'{indent}    prefix += {text!r}', f'{indent}pos += 1']
+            return [
+                f'{indent}k = len(prefix) - pos',
+                f'{indent}if k < {len(text)}:',
+                f'{indent}    prefix += {text!r}[k:]',
+                f'{indent}pos += {len(text)}',
+            ]
+        if kind in ('range', 'any', 'except'):
+            default = node[1] if kind != 'except' else ''
+            lines = [f'{indent}if pos < len(prefix):', f'{indent}    pos += 1']
+            if default:
+                lines += [f'{indent}else:', f'{indent}    prefix += {default[0]!r}', f'{indent}    pos += 1']
+            return lines
+        if kind == 'ref':
+            return [f'{indent}prefix, pos = p_{self.index[node[1]]}(prefix, pos)']
+        if kind == 'opt':
+            return [
+                f'{indent}if pos < len(prefix):',
+                f'{indent}    c = prefix[pos]',
+                f'{indent}    if {self.matches(node[1])}:',
+            ] + self.statements(node[1], indent + '        ')
+        if kind == 'rep':
+            return [
+                f'{indent}while pos < len(prefix):',
+                f'{indent}    c = prefix[pos]',
+                f'{indent}    if not {self.matches(node[1])}:',
+                f'{indent}        break',
+            ] + self.statements(node[1], indent + '    ')
+        if kind == 'seq':
+            return [line for child in node[1] for line in self.statements(child, indent)]
+        # or: the first child matching the next character, else (also at the end of the prefix) the first child
+        first, rest = node[1][0], node[1][1:]
+        others = ' or '.join(self.matches(child) for child in rest)
+        lines = [
+            f'{indent}c = prefix[pos] if pos < len(prefix) else None',
+            f'{indent}if c is None or {self.matches(first)} or not ({others}):',
+        ] + self.statements(first, indent + '    ')
+        for child in rest:
+            lines += [f'{indent}elif {self.matches(child)}:'] + self.statements(child, indent + '    ')
+        return lines
+
+
+def generate(text):
+    '''The Python source compile_grammar() runs for a grammar.'''
+    return _Generator(parse_grammar(text)).source()
+
+
+def cache_dir():
+    '''Where compiled grammars are kept: $JSON_AUTOCOMPLETE_CACHE, or json_autocomplete in the user's cache directory.'''
+    if os.environ.get('JSON_AUTOCOMPLETE_CACHE'):
+        return os.environ['JSON_AUTOCOMPLETE_CACHE']
+    base = os.environ.get('XDG_CACHE_HOME') or os.path.join(os.path.expanduser('~'), '.cache')
+    return os.path.join(base, 'json_autocomplete')
+
+def _load_code(text, directory):
+    key = hashlib.sha256(f'{_VERSION}\0{text}'.encode()).hexdigest()
+    path = None
+    if directory:
+        # marshal data is specific to the Python version
+        path = os.path.join(directory, f'{key}.{sys.implementation.cache_tag}.bin')
+        try:
+            with open(path, 'rb') as f:
+                return marshal.load(f)
+        except (OSError, EOFError, ValueError, TypeError):
+            pass
+
+    code = compile(generate(text), f'<grammar {key[:12]}>', 'exec')
+    if path:
+        try:
+            os.makedirs(directory, exist_ok=True)
+            temp = f'{path}.{os.getpid()}.tmp'
+            with open(temp, 'wb') as f:
+                marshal.dump(code, f)
+            os.replace(temp, path) # atomic, for concurrent starts
+        except OSError:
+            pass # the cache is only an optimization
+    return code
+
+
+class CompiledGrammar:
+    '''A grammar compiled by compile_grammar(). Calling it completes a prefix with its start rule, like a json.py function.'''
+    def __init__(self, text, start, rules):
+        self.text = text
+        self.start = start
+        self.rules = rules # rule name -> function(prefix, pos) -> (prefix, pos), like a parser
+        self._start = rules[start]
+
+    def __call__(self, prefix: str) -> str:
+        completed, pos = self._start(prefix, 0)
+        assert pos == len(completed) # prefix must be fully consumed
+        return completed
+
+
+def compile_grammar(text, start=None, cache=True):
+    '''Compile a grammar to Python code, and return a function that completes a prefix of its `start` rule (by default the first one) in a minimal way.
+    The compiled code is cached on disk (see cache_dir(); cache=False skips it, or a directory can be given instead), and a cached grammar is not parsed again.'''
+    directory = cache_dir() if cache is True else cache or None
+    namespace = {}
+    exec(_load_code(text, directory), namespace)
+    rules = namespace['RULES']
+    start = next(iter(rules)) if start is None else start
+    if start not in rules:
+        raise GrammarError(f'no rule {start!r}')
+    return CompiledGrammar(text, start, rules)
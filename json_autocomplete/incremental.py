@@ -0,0 +1,574 @@
+'''
+Incremental, pure Python counterpart of jac::Completer (native/src/completer.cpp).
+json_autocomplete() re-parses the whole prefix on every call; a Completer instead consumes the document chunk by chunk, walking the same grammar as an explicit state machine over a stack of open containers, and can produce the same minimal completion at any point in O(depth).
+Runs of string bodies, whitespace and digits are skipped with regular expressions, so the Python-level work is per token rather than per character.
+
+While parsing, a Completer reports what it sees to an optional Handler, together with the path (see paths.py) of each value, which is what the streaming features of this package are built on.
+In compact mode, feed() also returns its chunk minified: since all insignificant whitespace goes through the same skipping, dropping it costs one slice per whitespace run, and no re-serialization.
+With an indent, the output is re-indented instead, like json.dumps(..., indent=...) would lay it out. The output of feed() is stable (it never has to be taken back), and suffix() closes the open containers on their own indented lines, from the container stack.
+'''
+
+
+import json
+import re
+
+from .fingerprint import RunningHash
+from .tape import NUMBER, Tape
+
+
+# Parser states, the same as in jac::Completer
+(
+    VALUE,          # expecting a value (top level, after ':' or after ',' in an array)
+    ARRAY_FIRST,    # after '[': a value or ']'
+    OBJECT_FIRST,   # after '{': a key or '}'
+    KEY,            # after ',' in an object: a key
+    KEY_STRING,     # inside a key
+    KEY_ESCAPE,     # after '\' inside a key
+    KEY_UNICODE,    # inside "\uXXXX" in a key
+    COLON,          # after a key: ':'
+    STRING,         # inside a string value
+    ESCAPE,         # after '\' inside a string value
+    UNICODE,        # inside "\uXXXX" in a string value
+    LITERAL,        # inside null/true/false
+    NUM_MINUS,      # after '-'
+    NUM_ZERO,       # after a leading '0'
+    NUM_INT,        # inside the integer part
+    NUM_DOT,        # after '.'
+    NUM_FRAC,       # inside the fraction
+    NUM_EXP,        # after 'e' / 'E'
+    NUM_EXP_SIGN,   # after the exponent sign
+    NUM_EXP_DIGITS, # inside the exponent
+    AFTER_VALUE,    # a value just ended: ',', a closing bracket or whitespace
+    ERROR,
+) = range(22)
+
+# What json.py appends in each state, before closing the open containers
+_TAILS = {
+    VALUE: 'null',
+    KEY: '"":null',
+    KEY_STRING: '":null',
+    KEY_ESCAPE: '"":null',
+    COLON: ':null',
+    STRING: '"',
+    ESCAPE: '""',
+    NUM_MINUS: '0',
+    NUM_DOT: '0',
+    NUM_EXP: '0',
+    NUM_EXP_SIGN: '0',
+}
+
+_NUMBER_STATES = frozenset((NUM_MINUS, NUM_ZERO, NUM_INT, NUM_DOT, NUM_FRAC, NUM_EXP, NUM_EXP_SIGN, NUM_EXP_DIGITS))
+_KEY_STATES = frozenset((KEY_STRING, KEY_ESCAPE, KEY_UNICODE))
+_WS = ' \t\n\r'
+_DIGITS = '0123456789'
+_HEX = frozenset('0123456789abcdefABCDEF')
+_ESCAPES = frozenset('"\\/bfnrt')
+_LITERALS = {'n': 'null', 't': 'true', 'f': 'false'}
+_UNESCAPE = {'"': '"', '\\': '\\', '/': '/', 'b': '\b', 'f': '\f', 'n': '\n', 'r': '\r', 't': '\t'}
+
+_STRING_RUN = re.compile(r'[^"\\]+')
+_WS_RUN = re.compile(r'[ \t\n\r]+')
+_DIGIT_RUN = re.compile(r'[0-9]+')
+_NUMBER = re.compile(r'-?(?:0|[1-9][0-9]*)(?:\.[0-9]+)?(?:[eE][-+]?[0-9]+)?')
+# complete numbers inside an array, each followed by its comma
+_NUMBER_RUN = re.compile(r'(?:-?(?:0|[1-9][0-9]*)(?:\.[0-9]+)?(?:[eE][-+]?[0-9]+)?[ \t\n\r]*,[ \t\n\r]*)+')
+
+
+def decode_key(raw):
+    '''Decode the raw text between the quotes of a key.'''
+    return json.loads(f'"{raw}"') if '\\' in raw else raw
+
+class KeyTable:
+    '''Interns object keys: every occurrence of a key resolves to one shared str, looked up by its raw text, so documents that repeat the same keys do not allocate (and hash) them again.
+    At most `max_size` keys are kept; past that, new keys are decoded but not remembered.'''
+    def __init__(self, max_size=1024):
+        self.max_size = max_size
+        self.names = {} # raw text -> decoded key
+
+    def name(self, raw):
+        name = self.names.get(raw)
+        if name is None:
+            name = decode_key(raw)
+            if len(self.names) < self.max_size:
+                self.names[raw] = name
+        return name
+
+    def clear(self):
+        self.names.clear()
+
+# for one-shot parsing, shared by all threads (dict operations are atomic)
+SHARED_KEYS = KeyTable(4096)
+
+
+def join_surrogates(pending, code):
+    '''Decode the \\uXXXX escape `code` after `pending` (a high surrogate still waiting for its low half, or ''), as json.loads would.
+    Returns the decoded text and the new pending surrogate.'''
+    if pending and 0xDC00 <= code < 0xE000:
+        return chr(0x10000 + ((ord(pending) - 0xD800) << 10) + code - 0xDC00), ''
+    if 0xD800 <= code < 0xDC00:
+        return pending, chr(code)
+    return pending + chr(code), ''
+
+
+class Handler:
+    '''Receives what a Completer parses, as it is fed (SAX-style). All methods do nothing by default.
+    `path` is the Completer's live path list (keys and indices from the root): the path of the container for start_*/end_* and key(), and of the value otherwise. Copy it to keep it.
+    Values are reported when they are complete, except strings, which arrive in decoded pieces as they are fed.'''
+    def start_object(self, path):
+        pass
+
+    def end_object(self, path):
+        pass
+
+    def start_array(self, path):
+        pass
+
+    def end_array(self, path):
+        pass
+
+    def key(self, path, name):
+        pass
+
+    def string_chunk(self, path, text, last):
+        '''The next decoded piece of a string value; `last` is True for the piece that ends it (possibly empty).'''
+        pass
+
+    def number(self, path, text):
+        pass
+
+    def bool(self, path, value):
+        pass
+
+    def null(self, path):
+        pass
+
+    def numbers(self, path, text):
+        '''A run of complete numbers inside an array, each followed by its comma (and maybe whitespace), e.g. '1, 2.5, -3, '. path is that of the first one.
+        By default, number() is called for each.'''
+        path = list(path)
+        for item in text.split(',')[:-1]:
+            self.number(path, item.strip(_WS))
+            path[-1] += 1
+
+
+class Completer:
+    '''An incremental completer: feed() the chunks of a JSON document as they arrive, and get the suffix() that completes everything fed so far at any point.
+    As with json_autocomplete(), the input must be a prefix of a valid JSON document; anything else raises ValueError and leaves the Completer failed until reset().
+    With compact=True, feed() returns the chunk without insignificant whitespace, and the concatenation of its results plus suffix() is the minified completion.
+    With an indent (a number of spaces or a string, as for json.dumps), feed() returns the chunk pretty-printed instead, and suffix() is indented to match.
+    With tape=True, the Completer also indexes every value it reads in `tape` (see tape.py), with offsets counted from the start of everything fed.
+    Keys are interned in `keys`, a KeyTable of this Completer's own unless one is given (e.g. SHARED_KEYS); it is kept across reset(), so it serves all the documents of a session.
+    With a `digest` (a hashlib algorithm name, e.g. 'blake2b'), the output is hashed as it is fed, and fingerprint() is the hash of the current completion (see fingerprint.py).'''
+    def __init__(self, handler=None, compact=False, indent=None, tape=False, keys=None, digest=None):
+        self.handler = handler
+        self.keys = KeyTable() if keys is None else keys
+        self.hash = RunningHash(digest) if digest else None
+        self.compact = compact or indent is not None
+        self.indent = ' ' * indent if isinstance(indent, int) else indent
+        self.tape = Tape() if tape else None
+        self.reset()
+
+    def reset(self):
+        self._state = VALUE
+        self.consumed = 0       # characters fed so far
+        if self.hash is not None:
+            self.hash.reset()
+        if self.tape is not None:
+            self.tape.clear()
+        self._stack = []        # closing bracket of every open container, innermost last
+        self.path = []          # per open container, the current key (None before the first one) or index
+        self._literal = None
+        self._literal_pos = 0
+        self._hex = 0
+        self._code = 0          # value of the \\uXXXX escape being read in a string
+        self._surrogate = ''    # a high surrogate from the last escape, waiting for its low half
+        self._token = []        # pieces of the key or number being read, from previous chunks
+        self._token_start = 0   # where it starts in the current chunk
+
+    @property
+    def failed(self):
+        return self._state == ERROR
+
+    @property
+    def depth(self):
+        return len(self._stack)
+
+    def suffix(self) -> str:
+        state = self._state
+        if state == ERROR:
+            raise ValueError('the completer failed, reset() it first')
+        if state == LITERAL:
+            tail = self._literal[self._literal_pos:]
+        elif state == KEY_UNICODE:
+            tail = '0' * (4 - self._hex) + '":null'
+        elif state == UNICODE:
+            tail = '0' * (4 - self._hex) + '"'
+        else:
+            tail = _TAILS.get(state, '')
+        if self.indent is None:
+            return tail + ''.join(reversed(self._stack))
+
+        # an empty container is closed in place, any other on its own line
+        stack = self._stack
+        closers = [tail.replace(':', ': ')]
+        for depth in range(len(stack) - 1, -1, -1):
+            if depth < len(stack) - 1 or state not in (ARRAY_FIRST, OBJECT_FIRST):
+                closers.append('\n' + self.indent * depth)
+            closers.append(stack[depth])
+        return ''.join(closers)
+
+    def close_events(self):
+        '''Send the handler the events that complete the document the way suffix() does: the end of the value in progress (json.py completes it), then the end of every open container.
+        The Completer itself is left as it is, but the handler takes these events like any others and closes its open containers: to feed further, it must save and restore its own state around this call, as Writer.suffix() does.'''
+        handler, state = self.handler, self._state
+        if handler is None:
+            raise ValueError('close_events() needs a handler')
+        if state == ERROR:
+            raise ValueError('the completer failed, reset() it first')
+        path = list(self.path)
+        if state in _KEY_STATES or state == KEY:
+            raw = ''.join(self._token)
+            if state == KEY_ESCAPE:
+                raw += '"'
+            elif state == KEY_UNICODE:
+                raw += '0' * (4 - self._hex)
+            path[-1] = self.keys.name(raw) if state != KEY else ''
+            handler.key(path[:-1], path[-1])
+            handler.null(path)
+        elif state == COLON or state == VALUE:
+            handler.null(path)
+        elif state == STRING:
+            handler.string_chunk(path, self._surrogate, True)
+        elif state == ESCAPE:
+            handler.string_chunk(path, self._surrogate + '"', True)
+        elif state == UNICODE:
+            text, pending = join_surrogates(self._surrogate, self._code << 4 * (4 - self._hex))
+            handler.string_chunk(path, text + pending, True)
+        elif state == LITERAL:
+            self._literal_event(path)
+        elif state in _NUMBER_STATES:
+            handler.number(path, ''.join(self._token) + _TAILS.get(state, ''))
+        for closer in reversed(self._stack):
+            path.pop()
+            if closer == '}':
+                handler.end_object(path)
+            else:
+                handler.end_array(path)
+
+    def finish(self):
+        '''Declare the end of the document, which must be complete by now. This ends a top-level number, which is otherwise only known to be over once something follows it.'''
+        state = self._state
+        if state in (NUM_ZERO, NUM_INT, NUM_FRAC, NUM_EXP_DIGITS) and not self._stack:
+            self._end_number('', 0)
+        elif state != AFTER_VALUE or self._stack:
+            raise ValueError('the document is not complete')
+
+    def feed(self, chunk):
+        if self._state == ERROR:
+            raise ValueError('the completer failed, reset() it first')
+        try:
+            output = self._feed(chunk)
+        except ValueError:
+            self._state = ERROR
+            raise
+        self.consumed += len(chunk)
+        if self.hash is not None:
+            self.hash.update(chunk if output is None else output)
+        return output
+
+    def fingerprint(self) -> str:
+        '''The hex digest of the completion of everything fed so far (minified or pretty-printed, in those modes).'''
+        return self.hash.fingerprint(self.suffix())
+
+    def _fail(self, chunk, i):
+        raise ValueError(f'unexpected {chunk[i]!r}, not a prefix of a valid JSON document')
+
+    def _begin_value(self, chunk, i):
+        c = chunk[i]
+        handler = self.handler
+        if self.tape is not None:
+            if c == '{' or c == '[':
+                self.tape._start(c, self.consumed + i)
+            elif c in '"-0123456789' or c in _LITERALS:
+                self.tape._begin(c, self.consumed + i)
+        if c == '"':
+            self._state = STRING
+        elif c in '-0123456789':
+            self._state = NUM_MINUS if c == '-' else NUM_ZERO if c == '0' else NUM_INT
+            self._token = []
+            self._token_start = i
+        elif c == '{':
+            if handler:
+                handler.start_object(self.path)
+            self._stack.append('}')
+            self.path.append(None)
+            self._state = OBJECT_FIRST
+        elif c == '[':
+            if handler:
+                handler.start_array(self.path)
+            self._stack.append(']')
+            self.path.append(0)
+            self._state = ARRAY_FIRST
+        elif c in _LITERALS:
+            self._literal = _LITERALS[c]
+            self._literal_pos = 1
+            self._state = LITERAL
+        else:
+            self._fail(chunk, i)
+
+    def _close(self, offset):
+        closer = self._stack.pop()
+        self.path.pop()
+        self._state = AFTER_VALUE
+        if self.tape is not None:
+            self.tape._finish(closer, offset)
+        if self.handler:
+            if closer == '}':
+                self.handler.end_object(self.path)
+            else:
+                self.handler.end_array(self.path)
+
+    def _literal_event(self, path):
+        if self._literal == 'null':
+            self.handler.null(path)
+        else:
+            self.handler.bool(path, self._literal == 'true')
+
+    def _string_chunk(self, text, last):
+        if self._surrogate:
+            text = self._surrogate + text
+            self._surrogate = ''
+        self.handler.string_chunk(self.path, text, last)
+
+    def _end_number(self, chunk, i):
+        self._state = AFTER_VALUE
+        if self.tape is not None:
+            self.tape._end(self.consumed + i)
+        if self.handler:
+            self._token.append(chunk[self._token_start:i])
+            self.handler.number(self.path, ''.join(self._token))
+
+    def _feed(self, chunk):
+        i, n = 0, len(chunk)
+        stack = self._stack
+        self._token_start = 0
+        output = [] if self.compact else None
+        start = 0 # of the output not yet appended
+        indent = self.indent
+        tape = self.tape
+        while i < n:
+            state = self._state
+            c = chunk[i]
+
+            if state == STRING:
+                m = _STRING_RUN.match(chunk, i)
+                text = ''
+                if m:
+                    text = chunk[i:m.end()]
+                    i = m.end()
+                    if i == n:
+                        if self.handler:
+                            self._string_chunk(text, False)
+                        break
+                    c = chunk[i]
+                if c == '"':
+                    self._state = AFTER_VALUE
+                    if tape is not None:
+                        tape._end(self.consumed + i + 1)
+                    if self.handler:
+                        self._string_chunk(text, True)
+                else:
+                    self._state = ESCAPE
+                    if self.handler and text:
+                        self._string_chunk(text, False)
+                i += 1
+
+            elif state == AFTER_VALUE or state == VALUE or state == ARRAY_FIRST or state == OBJECT_FIRST or state == KEY or state == COLON:
+                if c in _WS:
+                    end = _WS_RUN.match(chunk, i).end()
+                    if output is not None:
+                        output.append(chunk[start:i])
+                        start = end
+                    i = end
+                    continue
+                if state == AFTER_VALUE:
+                    if not stack:
+                        self._fail(chunk, i) # only whitespace may follow the top-level value
+                    if c == ',':
+                        if indent is not None:
+                            output += (chunk[start:i], ',\n' + indent * len(stack))
+                            start = i + 1
+                        if stack[-1] == '}':
+                            self._state = KEY
+                        else:
+                            self._state = VALUE
+                            self.path[-1] += 1
+                    elif c == stack[-1]:
+                        if indent is not None:
+                            output += (chunk[start:i], '\n' + indent * (len(stack) - 1) + c)
+                            start = i + 1
+                        self._close(self.consumed + i)
+                    else:
+                        self._fail(chunk, i)
+                    i += 1
+                elif state == VALUE or state == ARRAY_FIRST:
+                    if state == ARRAY_FIRST and c == ']':
+                        self._close(self.consumed + i)
+                        i += 1
+                    elif c in '-0123456789' and stack and stack[-1] == ']' and (m := _NUMBER_RUN.match(chunk, i)):
+                        # a run of numbers inside an array, in one go
+                        run = chunk[i:m.end()]
+                        if self.handler:
+                            self.handler.numbers(self.path, run)
+                        self.path[-1] += run.count(',')
+                        if tape is not None:
+                            base = self.consumed + i
+                            for number in _NUMBER.finditer(run):
+                                tape._add(NUMBER, base + number.start(), number.end() - number.start())
+                        if output is not None:
+                            output.append(chunk[start:i])
+                            if indent is None:
+                                output.append(_WS_RUN.sub('', run))
+                            else:
+                                newline = '\n' + indent * len(stack)
+                                if state == ARRAY_FIRST:
+                                    output.append(newline)
+                                newline = ',' + newline
+                                output.append(''.join([item.strip(_WS) + newline for item in run.split(',')[:-1]]))
+                            start = m.end()
+                        self._state = VALUE
+                        i = m.end()
+                    else:
+                        if indent is not None and state == ARRAY_FIRST:
+                            output += (chunk[start:i], '\n' + indent * len(stack))
+                            start = i
+                        self._begin_value(chunk, i)
+                        i += 1
+                elif state == COLON:
+                    if c != ':':
+                        self._fail(chunk, i)
+                    if indent is not None:
+                        output += (chunk[start:i], ': ')
+                        start = i + 1
+                    self._state = VALUE
+                    i += 1
+                else: # OBJECT_FIRST, KEY
+                    if c == '"':
+                        if indent is not None and state == OBJECT_FIRST:
+                            output += (chunk[start:i], '\n' + indent * len(stack))
+                            start = i
+                        self._state = KEY_STRING
+                        self._token = []
+                        self._token_start = i + 1
+                        if tape is not None:
+                            tape._begin(c, self.consumed + i)
+                    elif c == '}' and state == OBJECT_FIRST:
+                        self._close(self.consumed + i)
+                    else:
+                        self._fail(chunk, i)
+                    i += 1
+
+            elif state == KEY_STRING:
+                m = _STRING_RUN.match(chunk, i)
+                if m:
+                    i = m.end()
+                    if i == n:
+                        break
+                    c = chunk[i]
+                if c == '"':
+                    self._token.append(chunk[self._token_start:i])
+                    name = self.keys.name(''.join(self._token))
+                    self.path[-1] = name
+                    if self.handler:
+                        self.handler.key(self.path[:-1], name)
+                    if tape is not None:
+                        tape._end(self.consumed + i + 1)
+                    self._state = COLON
+                else:
+                    self._state = KEY_ESCAPE
+                i += 1
+
+            elif state == NUM_INT or state == NUM_FRAC or state == NUM_EXP_DIGITS or state == NUM_ZERO:
+                if state != NUM_ZERO and c in _DIGITS:
+                    i = _DIGIT_RUN.match(chunk, i).end()
+                    continue
+                if c == '.' and (state == NUM_INT or state == NUM_ZERO):
+                    self._state = NUM_DOT
+                    i += 1
+                elif c in 'eE' and state != NUM_EXP_DIGITS:
+                    self._state = NUM_EXP
+                    i += 1
+                else:
+                    # the number is over, the character belongs to whatever follows it
+                    self._end_number(chunk, i)
+
+            elif state == NUM_MINUS:
+                if c == '0':
+                    self._state = NUM_ZERO
+                elif c in _DIGITS:
+                    self._state = NUM_INT
+                else:
+                    self._fail(chunk, i)
+                i += 1
+
+            elif state == NUM_DOT or state == NUM_EXP or state == NUM_EXP_SIGN:
+                if state == NUM_EXP and c in '+-':
+                    self._state = NUM_EXP_SIGN
+                elif c in _DIGITS:
+                    self._state = NUM_FRAC if state == NUM_DOT else NUM_EXP_DIGITS
+                else:
+                    self._fail(chunk, i)
+                i += 1
+
+            elif state == ESCAPE or state == KEY_ESCAPE:
+                if c == 'u':
+                    self._hex = self._code = 0
+                    self._state = UNICODE if state == ESCAPE else KEY_UNICODE
+                elif c in _ESCAPES:
+                    if state == ESCAPE:
+                        self._state = STRING
+                        if self.handler:
+                            self._string_chunk(_UNESCAPE[c], False)
+                    else:
+                        self._state = KEY_STRING
+                else:
+                    self._fail(chunk, i)
+                i += 1
+
+            elif state == UNICODE or state == KEY_UNICODE:
+                if c not in _HEX:
+                    self._fail(chunk, i)
+                self._hex += 1
+                self._code = self._code << 4 | int(c, 16)
+                if self._hex == 4:
+                    if state == UNICODE:
+                        self._state = STRING
+                        if self.handler:
+                            text, self._surrogate = join_surrogates(self._surrogate, self._code)
+                            if text:
+                                self.handler.string_chunk(self.path, text, False)
+                    else:
+                        self._state = KEY_STRING
+                i += 1
+
+            elif state == LITERAL:
+                if c != self._literal[self._literal_pos]:
+                    self._fail(chunk, i)
+                self._literal_pos += 1
+                if self._literal_pos == len(self._literal):
+                    self._state = AFTER_VALUE
+                    if tape is not None:
+                        tape._end(self.consumed + i + 1)
+                    if self.handler:
+                        self._literal_event(self.path)
+                i += 1
+
+            else: # ERROR
+                self._fail(chunk, i)
+
+        # carry an unfinished key or number over to the next chunk
+        if self._state in _KEY_STATES or (self.handler and self._state in _NUMBER_STATES):
+            self._token.append(chunk[self._token_start:])
+        if output is not None:
+            output.append(chunk[start:])
+            return ''.join(output)
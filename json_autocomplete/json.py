@@ -7,6 +7,7 @@ More specifically, for whitespaces, we always make a construct (the CamelCase gl
 '''
 
 
+from .incremental import Completer
 from .parser import *
 
 
@@ -60,12 +61,12 @@ String = Seq(
     Lit('"')
 )
 
-# Forward references for recursive structures
-Value = Reference(None)
-Object = Reference(None)
-Array = Reference(None)
+# Forward references for recursive structures, defined below
+Value = Reference(min_len=1)
+Object = Reference(min_len=2)
+Array = Reference(min_len=2)
 
-Value.child = Seq(
+Value.define(Seq(
     Or(
         Lit('null'),
         String,
@@ -76,8 +77,7 @@ Value.child = Seq(
         Lit('false')
     ),
     WS
-)
-Value.min_len = lambda: 1
+))
 
 KeyValue = Seq(
     String, WS,
@@ -91,12 +91,11 @@ MemberList = Seq(
         KeyValue,
     ))
 )
-Object.child = Seq(
+Object.define(Seq(
     Lit('{'), WS,
     Opt(MemberList),
     Lit('}')
-)
-Object.min_len = lambda: 2
+))
 
 ValueList = Seq(
     Value,
@@ -105,17 +104,20 @@ ValueList = Seq(
         Value
     ))
 )
-Array.child = Seq(
+Array.define(Seq(
     Lit('['), WS,
     Opt(ValueList),
     Lit(']')
-)
-Array.min_len = lambda: 2
+))
 
 WSValue = Seq(WS, Value)
 
-def json_autocomplete(prefix: str) -> str:
-    """Autocomplete any prefix of a JSON string in a minimal way. Returns the completed string."""
+def json_autocomplete(prefix: str, compact=False, indent=None) -> str:
+    """Autocomplete any prefix of a JSON string in a minimal way. Returns the completed string.
+    With compact=True, the whitespace between tokens is dropped from the result, and with an indent, the result is re-indented like json.dumps(..., indent=indent) would (in the same pass, see incremental.py)."""
+    if compact or indent is not None:
+        completer = Completer(compact=compact, indent=indent)
+        return completer.feed(prefix) + completer.suffix()
     completed, pos = WSValue(prefix, 0)
     assert pos == len(completed) # prefix must be fully consumed
     return completed
\ No newline at end of file
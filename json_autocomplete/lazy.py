@@ -0,0 +1,118 @@
+'''
+Lazy views of partial documents.
+loads_partial_lazy() indexes the completed document with a tape (see tape.py) in one pass, and returns read-only Mapping / Sequence proxies over it: a value is only decoded when it is accessed, and then cached.
+Reading a few fields of a large payload costs the index plus those fields, instead of building every object of the document.
+'''
+
+
+from collections.abc import Mapping, Sequence
+
+from .incremental import SHARED_KEYS, Completer
+from .tape import ARRAY, OBJECT
+
+
+def loads_partial_lazy(prefix, keys=SHARED_KEYS):
+    '''The value of json.loads(json_autocomplete(prefix)), with objects and arrays as lazy LazyObject / LazyArray proxies.
+    Keys are interned in `keys` (see KeyTable), by default a bounded table shared by all calls.'''
+    completer = Completer(tape=True, keys=keys)
+    completer.feed(prefix)
+    suffix = completer.suffix()
+    completer.feed(suffix)
+    completer.finish()
+    return _view(prefix + suffix, completer.tape, 0, keys)
+
+def _view(text, tape, i, keys):
+    kind = tape.type(i)
+    if kind == OBJECT:
+        return LazyObject(text, tape, i, keys)
+    if kind == ARRAY:
+        return LazyArray(text, tape, i, keys)
+    return tape.decode(text, i)
+
+
+class LazyObject(Mapping):
+    '''A JSON object, decoded member by member on access. Keys are all decoded on first access, values when read.'''
+    def __init__(self, text, tape, index, keys):
+        self._text = text
+        self._tape = tape
+        self._index = index
+        self._keys_table = keys
+        self._members = None # key -> tape index of the value
+        self._values = {}
+
+    def _keys(self):
+        if self._members is None:
+            tape, text, name = self._tape, self._text, self._keys_table.name
+            children = list(tape.children(self._index))
+            self._members = {name(tape.raw(text, children[k])[1:-1]): children[k + 1] for k in range(0, len(children), 2)}
+        return self._members
+
+    def __getitem__(self, key):
+        try:
+            return self._values[key]
+        except KeyError:
+            value = self._values[key] = _view(self._text, self._tape, self._keys()[key], self._keys_table)
+            return value
+
+    def __iter__(self):
+        return iter(self._keys())
+
+    def __len__(self):
+        return len(self._keys())
+
+    def __contains__(self, key):
+        return key in self._keys()
+
+    def raw(self):
+        '''The JSON text of the object.'''
+        return self._tape.raw(self._text, self._index)
+
+    def __repr__(self):
+        return f'LazyObject({self.raw()})'
+
+
+class LazyArray(Sequence):
+    '''A JSON array, decoded element by element on access.'''
+    def __init__(self, text, tape, index, keys):
+        self._text = text
+        self._tape = tape
+        self._index = index
+        self._keys_table = keys
+        self._elements = None # tape index of every element
+        self._values = {}
+
+    def _children(self):
+        if self._elements is None:
+            self._elements = list(self._tape.children(self._index))
+        return self._elements
+
+    def __getitem__(self, index):
+        if isinstance(index, slice):
+            return [self[i] for i in range(*index.indices(len(self)))]
+        elements = self._children()
+        if index < 0:
+            index += len(elements)
+        if not 0 <= index < len(elements):
+            raise IndexError('array index out of range')
+        try:
+            return self._values[index]
+        except KeyError:
+            value = self._values[index] = _view(self._text, self._tape, elements[index], self._keys_table)
+            return value
+
+    def __len__(self):
+        return len(self._children())
+
+    def __eq__(self, other):
+        if not isinstance(other, Sequence) or isinstance(other, (str, bytes)):
+            return NotImplemented
+        return len(self) == len(other) and all(a == b for a, b in zip(self, other))
+
+    __hash__ = None
+
+    def raw(self):
+        '''The JSON text of the array.'''
+        return self._tape.raw(self._text, self._index)
+
+    def __repr__(self):
+        return f'LazyArray({self.raw()})'
@@ -0,0 +1,197 @@
+'''
+Parsing JSON prefixes straight into Python objects.
+loads_partial(prefix) is json.loads(json_autocomplete(prefix)) in one pass: a Builder receives the events of an incremental.Completer and assembles the objects directly, and close_events() supplies what the completion would have added.
+Neither the completed string nor a second parse by json.loads is needed.
+
+A Builder can also follow a stream: its containers are in place as soon as they open, so `value` is always the document read so far.
+With ropes=True, strings still being read are in place too, as Rope objects that grow in O(chunk) per update instead of a str rebuilt each time.
+A Rope is not a str subclass, so json.dumps() needs default=json_default for such a document (or to_plain() to copy it with plain strings).
+With sinks, the content of large string fields goes to files or callbacks as it arrives (see sinks.py), and the document only holds a preview of it.
+'''
+
+
+from .incremental import SHARED_KEYS, Completer, Handler
+from .native import decode_number, decode_numbers
+from .paths import PathSet
+
+
+class Rope:
+    '''A string value still being read: a list of pieces, joined only when the text is read (and then kept joined until the next piece).
+    Reads like a str: str(rope), len(), ==, indexing, `in`, iteration, and any str method (on the joined text).'''
+    __slots__ = ('_pieces', '_length')
+
+    def __init__(self, text=''):
+        self._pieces = [text] if text else []
+        self._length = len(text)
+
+    def append(self, text):
+        if text:
+            self._pieces.append(text)
+            self._length += len(text)
+
+    def __str__(self):
+        pieces = self._pieces
+        if len(pieces) > 1:
+            pieces[:] = [''.join(pieces)]
+        return pieces[0] if pieces else ''
+
+    def __len__(self):
+        return self._length
+
+    def __eq__(self, other):
+        if isinstance(other, (str, Rope)):
+            return str(self) == str(other)
+        return NotImplemented
+
+    __hash__ = None # it is still growing
+
+    def __getitem__(self, index):
+        return str(self)[index]
+
+    def __contains__(self, text):
+        return text in str(self)
+
+    def __iter__(self):
+        return iter(str(self))
+
+    def __add__(self, other):
+        return str(self) + str(other)
+
+    def __radd__(self, other):
+        return str(other) + str(self)
+
+    def __getattr__(self, name):
+        return getattr(str(self), name)
+
+    def __repr__(self):
+        return f'Rope({str(self)!r})'
+
+
+def json_default(value):
+    '''A `default=` for json.dump(s), which cannot serialize a Rope by itself: json.dumps(builder.value, default=json_default).'''
+    if isinstance(value, Rope):
+        return str(value)
+    raise TypeError(f'Object of type {type(value).__name__} is not JSON serializable')
+
+def to_plain(value):
+    '''A copy of a document with every Rope replaced by its str, for code that needs exact dict / list / str types.'''
+    if isinstance(value, dict):
+        return {key: to_plain(item) for key, item in value.items()}
+    if isinstance(value, list):
+        return [to_plain(item) for item in value]
+    if isinstance(value, Rope):
+        return str(value)
+    return value
+
+
+class Builder(Handler):
+    '''Assembles the Python objects of the document a Completer parses. `value` is the top-level value, complete or as read so far.
+    With ropes=True, a string value is put in place as a Rope at its first piece, and replaced by its str when it ends.
+    `sinks` maps path patterns (see paths.py) to Sink objects: the string fields at those paths are fed to their Sink instead, and hold its placeholder_value(), which follows the preview as the field streams in.'''
+    def __init__(self, ropes=False, sinks=None):
+        self.value = None
+        self.ropes = ropes
+        self.sinks = [(PathSet([pattern]), sink) for pattern, sink in (sinks or {}).items()]
+        self._containers = [] # the open dicts and lists, innermost last
+        self._string = []     # decoded pieces of the string value being read
+        self._rope = None     # or, with ropes, the Rope in place for it
+        self._sink = None     # or the Sink it goes to
+        self._reading = False # whether a string value has started
+
+    def _put(self, path, value):
+        if not self._containers:
+            self.value = value
+        elif path[-1].__class__ is int:
+            self._containers[-1].append(value)
+        else:
+            self._containers[-1][path[-1]] = value
+
+    def start_object(self, path):
+        container = {}
+        self._put(path, container)
+        self._containers.append(container)
+
+    def start_array(self, path):
+        container = []
+        self._put(path, container)
+        self._containers.append(container)
+
+    def end_object(self, path):
+        self._containers.pop()
+
+    end_array = end_object
+
+    def _replace(self, path, value):
+        if not self._containers:
+            self.value = value
+        elif path[-1].__class__ is int:
+            self._containers[-1][-1] = value
+        else:
+            self._containers[-1][path[-1]] = value
+
+    def _sink_for(self, path):
+        for paths, sink in self.sinks:
+            if paths.match(path):
+                return sink
+        return None
+
+    def string_chunk(self, path, text, last):
+        if self.sinks:
+            if not self._reading:
+                self._sink = self._sink_for(path)
+                if self._sink is not None:
+                    self._sink.begin()
+                    self._put(path, self._sink.placeholder_value())
+            self._reading = not last
+            if self._sink is not None:
+                changed = self._sink.feed(text)
+                if last:
+                    self._replace(path, self._sink.end())
+                    self._sink = None
+                elif changed:
+                    self._replace(path, self._sink.placeholder_value())
+                return
+        if self.ropes:
+            rope = self._rope
+            if last:
+                if rope is None:
+                    self._put(path, text)
+                else:
+                    rope.append(text)
+                    self._replace(path, str(rope))
+                    self._rope = None
+            elif rope is None:
+                self._rope = Rope(text)
+                self._put(path, self._rope)
+            else:
+                rope.append(text)
+        elif not last:
+            self._string.append(text)
+        elif self._string:
+            self._string.append(text)
+            self._put(path, ''.join(self._string))
+            self._string = []
+        else:
+            self._put(path, text)
+
+    def number(self, path, text):
+        self._put(path, decode_number(text))
+
+    def numbers(self, path, text):
+        self._containers[-1].extend(decode_numbers(text.split(',')[:-1]))
+
+    def bool(self, path, value):
+        self._put(path, value)
+
+    def null(self, path):
+        self._put(path, None)
+
+
+def loads_partial(prefix, keys=SHARED_KEYS):
+    '''Parse a JSON prefix into Python objects, as json.loads(json_autocomplete(prefix)) would: a partial string is cut where the prefix ends, 'tr' is True, '-' is 0, a missing value is None.
+    Keys are interned in `keys` (see KeyTable), by default a bounded table shared by all calls.'''
+    builder = Builder()
+    completer = Completer(builder, keys=keys)
+    completer.feed(prefix)
+    completer.close_events()
+    return builder.value
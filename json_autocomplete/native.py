@@ -0,0 +1,356 @@
+'''
+Bindings to the native completer in native/ (libjson_autocomplete), loaded through its C interface with ctypes.
+ctypes releases the GIL for the duration of every foreign call, so the batch functions below complete on the library's worker threads while the other Python threads keep running.
+The library is loaded on first use, not at import, from $JSON_AUTOCOMPLETE_LIB, next to this file, or else from the system library path.
+If it cannot be found, everything here falls back to the pure Python Completer in incremental.py, which rejects invalid input with the same ValueError (`available` tells which one is in use).
+'''
+
+
+import codecs
+import ctypes
+import os
+import sys
+import threading
+from array import array
+
+from .incremental import Completer
+
+
+JAC_OK = 0
+JAC_ERR_SYNTAX = -1
+JAC_ERR_BUFFER = -2
+JAC_ERR_MEMORY = -3
+
+SUFFIX_BOUND = 8 # JAC_SUFFIX_BOUND(n) == n + SUFFIX_BOUND
+
+JAC_NUMBER_INT = 0
+JAC_NUMBER_FLOAT = 1
+JAC_NUMBER_BIG_INT = 2
+
+
+def _library_names():
+    if sys.platform == 'win32':
+        return ['json_autocomplete.dll']
+    if sys.platform == 'darwin':
+        return ['libjson_autocomplete.dylib']
+    return ['libjson_autocomplete.so']
+
+def _load():
+    candidates = []
+    if os.environ.get('JSON_AUTOCOMPLETE_LIB'):
+        candidates.append(os.environ['JSON_AUTOCOMPLETE_LIB'])
+    here = os.path.dirname(os.path.abspath(__file__))
+    candidates += [os.path.join(here, name) for name in _library_names()]
+    candidates += _library_names() # a bare name makes the dynamic loader search the system path, without ctypes.util.find_library's subprocesses
+
+    for path in candidates:
+        try:
+            lib = ctypes.CDLL(path)
+        except OSError:
+            continue
+        _declare(lib)
+        return lib
+    return None
+
+class _Number(ctypes.Structure):
+    '''jac_number'''
+    _fields_ = [('kind', ctypes.c_int), ('integer', ctypes.c_longlong), ('real', ctypes.c_double)]
+
+def _declare(lib):
+    size_t, size_p, int_p = ctypes.c_size_t, ctypes.POINTER(ctypes.c_size_t), ctypes.POINTER(ctypes.c_int)
+    session, char_pp = ctypes.c_void_p, ctypes.POINTER(ctypes.c_char_p)
+
+    lib.jac_session_new.argtypes = []
+    lib.jac_session_new.restype = session
+    lib.jac_session_feed.argtypes = [session, ctypes.c_char_p, size_t]
+    lib.jac_session_feed.restype = ctypes.c_int
+    lib.jac_session_suffix.argtypes = [session, ctypes.c_char_p, size_t, size_p]
+    lib.jac_session_suffix.restype = ctypes.c_int
+    lib.jac_session_reset.argtypes = [session]
+    lib.jac_session_reset.restype = None
+    lib.jac_session_free.argtypes = [session]
+    lib.jac_session_free.restype = None
+    lib.jac_complete_many.argtypes = [size_t, char_pp, size_p, ctypes.c_char_p, size_t, size_p, int_p, size_t]
+    lib.jac_complete_many.restype = ctypes.c_int
+    lib.jac_feed_many.argtypes = [size_t, ctypes.POINTER(session), char_pp, size_p, int_p, size_t]
+    lib.jac_feed_many.restype = ctypes.c_int
+    lib.jac_parse_number.argtypes = [ctypes.c_char_p, size_t, ctypes.POINTER(_Number)]
+    lib.jac_parse_number.restype = ctypes.c_int
+    lib.jac_parse_numbers.argtypes = [ctypes.c_char_p, size_t, ctypes.c_char, size_t, ctypes.c_void_p, ctypes.c_void_p, ctypes.c_void_p]
+    lib.jac_parse_numbers.restype = size_t
+
+_UNLOADED = object()
+_lib = _UNLOADED
+_loading = threading.Lock()
+
+def _library():
+    '''The loaded library, or None if there is none.'''
+    global _lib
+    if _lib is _UNLOADED:
+        with _loading:
+            if _lib is _UNLOADED:
+                _lib = _load()
+    return _lib
+
+def __getattr__(name):
+    if name == 'available': # whether the library is in use, which loads it
+        return _library() is not None
+    raise AttributeError(f'module {__name__!r} has no attribute {name!r}')
+
+
+def _as_bytes(data):
+    '''str is encoded, bytes is passed to the library as is (borrowed), any other bytes-like object is copied.'''
+    if isinstance(data, str):
+        return data.encode()
+    if isinstance(data, bytes):
+        return data
+    return bytes(data)
+
+def _buffer_size(buffer):
+    with memoryview(buffer) as view:
+        return view.nbytes
+
+def _reserve(buffer, end):
+    '''Makes sure the buffer holds at least `end` bytes. Only a bytearray can grow (geometrically, so a reused buffer soon stops growing).'''
+    size = _buffer_size(buffer)
+    if end > size:
+        if not isinstance(buffer, bytearray):
+            raise ValueError(f'buffer too small, {end} bytes needed')
+        buffer.extend(bytes(max(end, 2 * size) - size))
+
+def _write(buffer, offset, data):
+    _reserve(buffer, offset + len(data))
+    with memoryview(buffer) as view:
+        view[offset:offset + len(data)] = data
+    return len(data)
+
+def _suffix_into(session, buffer, offset):
+    '''Lets the library write the suffix of a session straight into buffer[offset:], growing the buffer only if the suffix does not fit.'''
+    length = ctypes.c_size_t()
+    for _ in range(2):
+        room = max(_buffer_size(buffer) - offset, 0)
+        target = (ctypes.c_char * room).from_buffer(buffer, offset) if room else None
+        status = _lib.jac_session_suffix(session, target, room, length)
+        del target # a bytearray cannot grow while it is exported
+        if status != JAC_ERR_BUFFER:
+            break
+        _reserve(buffer, offset + length.value)
+    _check(status, 'stream')
+    return length.value
+
+def _complete(prefix):
+    '''The fallback for one prefix (str or bytes): the completed prefix, of the same type.'''
+    text = prefix if isinstance(prefix, str) else bytes(prefix).decode()
+    completer = Completer()
+    completer.feed(text)
+    suffix = completer.suffix()
+    return text + suffix if isinstance(prefix, str) else bytes(prefix) + suffix.encode()
+
+def _check(status, what):
+    if status == JAC_ERR_SYNTAX:
+        raise ValueError(f'{what} is not a prefix of a valid JSON document')
+    if status == JAC_ERR_MEMORY:
+        raise MemoryError
+    assert status == JAC_OK, status
+
+
+def complete_many(prefixes, threads=0):
+    '''Autocomplete many JSON prefixes at once. Returns the completed strings (or bytes, for bytes prefixes) in order.
+    The batch is completed in parallel on up to `threads` native threads (0: one per CPU), without holding the GIL.'''
+    prefixes = list(prefixes)
+    if _library() is None:
+        return [_complete(p) for p in prefixes]
+
+    n = len(prefixes)
+    data = [_as_bytes(p) for p in prefixes]
+    lengths = (ctypes.c_size_t * n)(*map(len, data))
+    capacity = sum(lengths) + SUFFIX_BOUND * n
+    out = ctypes.create_string_buffer(max(capacity, 1))
+    suffix_lengths = (ctypes.c_size_t * n)()
+    statuses = (ctypes.c_int * n)()
+    _check(_lib.jac_complete_many(n, (ctypes.c_char_p * n)(*data), lengths, out, capacity, suffix_lengths, statuses, threads), 'batch')
+
+    raw = out.raw
+    completed = []
+    offset = 0
+    for i, prefix in enumerate(prefixes):
+        _check(statuses[i], f'prefix {i}')
+        suffix = raw[offset:offset + suffix_lengths[i]]
+        completed.append(prefix + suffix.decode('ascii') if isinstance(prefix, str) else bytes(prefix) + suffix)
+        offset += lengths[i] + SUFFIX_BOUND
+    return completed
+
+
+class Stream:
+    '''An incremental completer: feed() the chunks of a JSON document as they arrive, and get the suffix() that completes everything fed so far at any point.
+    Backed by a native session if the library is available, otherwise by an incremental.Completer.'''
+    def __init__(self):
+        self._session = None
+        self._completer = None
+        self._buffer = None
+        if _library() is not None:
+            self._session = _lib.jac_session_new()
+            if not self._session:
+                raise MemoryError
+            self._buffer = ctypes.create_string_buffer(64)
+        else:
+            self._completer = Completer()
+            self._decoder = codecs.getincrementaldecoder('utf-8')() # bytes chunks may split a character
+
+    def feed(self, chunk):
+        if self._session is None:
+            self._completer.feed(chunk if isinstance(chunk, str) else self._decoder.decode(bytes(chunk)))
+        else:
+            data = _as_bytes(chunk)
+            _check(_lib.jac_session_feed(self._session, data, len(data)), 'stream')
+
+    def suffix(self) -> str:
+        if self._session is None:
+            return self._completer.suffix()
+        length = ctypes.c_size_t()
+        status = _lib.jac_session_suffix(self._session, self._buffer, len(self._buffer), length)
+        if status == JAC_ERR_BUFFER:
+            self._buffer = ctypes.create_string_buffer(length.value * 2)
+            status = _lib.jac_session_suffix(self._session, self._buffer, len(self._buffer), length)
+        _check(status, 'stream')
+        return self._buffer.raw[:length.value].decode('ascii')
+
+    def suffix_into(self, buffer, offset=0) -> int:
+        '''Write the suffix as UTF-8 into a writable buffer (bytearray, memoryview, mmap, ...) at `offset`, and return the number of bytes written.
+        No intermediate str or bytes is created. A bytearray is grown if the suffix does not fit, other buffers raise ValueError.'''
+        if self._session is None:
+            return _write(buffer, offset, self.suffix().encode())
+        return _suffix_into(self._session, buffer, offset)
+
+    def reset(self):
+        if self._session is not None:
+            _lib.jac_session_reset(self._session)
+        else:
+            self._completer.reset()
+            self._decoder.reset()
+
+    def close(self):
+        if self._session is not None and _lib is not None:
+            _lib.jac_session_free(self._session)
+            self._session = None
+            self._buffer = None
+
+    def __del__(self):
+        self.close()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+
+
+_local = threading.local()
+
+def complete_into(prefix, buffer, offset=0) -> int:
+    '''Write the completion of a JSON prefix (str or bytes) as UTF-8 into a writable buffer (bytearray, memoryview, mmap, ...) at `offset`, and return the number of bytes written.
+    A bytearray is grown if the completion does not fit, other buffers raise ValueError before anything is written.'''
+    if _library() is None:
+        completed = _complete(prefix)
+        return _write(buffer, offset, completed.encode() if isinstance(completed, str) else completed)
+
+    stream = getattr(_local, 'stream', None)
+    if stream is None:
+        stream = _local.stream = Stream()
+    else:
+        stream.reset()
+    data = _as_bytes(prefix)
+    stream.feed(data)
+    length = ctypes.c_size_t()
+    status = _lib.jac_session_suffix(stream._session, None, 0, length) # only measures the suffix
+    if status != JAC_ERR_BUFFER:
+        _check(status, 'prefix')
+    _reserve(buffer, offset + len(data) + length.value)
+    _write(buffer, offset, data)
+    return len(data) + _suffix_into(stream._session, buffer, offset + len(data))
+
+
+def feed_many(streams, chunks, threads=0):
+    '''Feed chunks[i] to streams[i] for all i at once, in parallel on up to `threads` native threads (0: one per CPU), without holding the GIL.
+    The streams must be distinct. All chunks are fed before the first failing one, if any, raises.'''
+    streams, chunks = list(streams), list(chunks)
+    assert len(streams) == len(chunks)
+    if _library() is None:
+        for stream, chunk in zip(streams, chunks):
+            stream.feed(chunk)
+        return
+
+    n = len(streams)
+    data = [_as_bytes(c) for c in chunks]
+    sessions = (ctypes.c_void_p * n)(*(s._session for s in streams))
+    statuses = (ctypes.c_int * n)()
+    lengths = (ctypes.c_size_t * n)(*map(len, data))
+    _check(_lib.jac_feed_many(n, sessions, (ctypes.c_char_p * n)(*data), lengths, statuses, threads), 'batch')
+    for i in range(n):
+        _check(statuses[i], f'chunk {i}')
+
+
+def decode_number(text):
+    '''Decode the text of a JSON number to an int or float, like json.loads would.
+    A prefix of a number is decoded as json_autocomplete would complete it: '-' is 0, '2.' is 2.0, '1e' is 1.0.
+    With the native library, it is parsed there (see decode_numbers), except for integers beyond 64 bits.'''
+    if _library() is not None:
+        data = _as_bytes(text)
+        number = _Number()
+        if _lib.jac_parse_number(data, len(data), number) != JAC_OK:
+            raise ValueError(f'{text!r} is not a prefix of a JSON number')
+        if number.kind == JAC_NUMBER_INT:
+            return number.integer
+        if number.kind == JAC_NUMBER_FLOAT:
+            return number.real
+    return _decode_number(text)
+
+def _decode_number(text):
+    if not text or text[-1] in '-+.eE':
+        text += '0'
+    if '.' in text or 'e' in text or 'E' in text:
+        return float(text)
+    return int(text)
+
+def decode_numbers(texts):
+    '''Decode many number texts (see decode_number) at once. Returns a list of ints and floats.
+    With the native library, the whole batch is parsed in one call with correctly rounded fast float parsing (Eisel-Lemire), instead of one float() or int() per text.'''
+    texts = list(texts)
+    if _library() is None:
+        return [_decode_number(t) for t in texts]
+
+    n = len(texts)
+    data = ','.join(texts).encode('ascii')
+    kinds = bytearray(n)
+    integers = array('q', bytes(8 * n))
+    reals = array('d', bytes(8 * n))
+    decoded = _lib.jac_parse_numbers(data, len(data), b',', n, _address(kinds), integers.buffer_info()[0], reals.buffer_info()[0])
+    if decoded < n:
+        raise ValueError(f'{texts[decoded]!r} is not a prefix of a JSON number')
+
+    floats = kinds.count(JAC_NUMBER_FLOAT)
+    if floats == n:
+        return reals.tolist()
+    if floats == 0 and JAC_NUMBER_BIG_INT not in kinds:
+        return integers.tolist()
+    return [
+        r if k == JAC_NUMBER_FLOAT else i if k == JAC_NUMBER_INT else _decode_number(t)
+        for k, i, r, t in zip(kinds, integers, reals, texts)
+    ]
+
+def extend_numbers(out, text, count):
+    '''Decode `count` numbers separated by commas (and maybe whitespace) from text, e.g. '1, 2.5, -3', and append them to `out`, an array('d').
+    With the native library, they are parsed straight into the array's memory: no float object is created per number.'''
+    if _library() is None:
+        out.extend(map(float, text.split(',', count)[:count]))
+        return
+    data = _as_bytes(text)
+    start = len(out)
+    out.frombytes(bytes(8 * count))
+    decoded = _lib.jac_parse_numbers(data, len(data), b',', count, None, None, out.buffer_info()[0] + 8 * start)
+    if decoded < count:
+        del out[start:]
+        raise ValueError(f'number {decoded} of {text!r} is not a JSON number')
+
+def _address(buffer):
+    return ctypes.addressof((ctypes.c_char * len(buffer)).from_buffer(buffer)) if len(buffer) else None
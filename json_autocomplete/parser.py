@@ -2,11 +2,24 @@
 This is a general "consumer" + "auto-filler" parser that takes a prefix of a grammar, and attempts to "consume", i.e. traverse it char-by-char according to the defined grammar as much as possible, and when it reaches the end of the string, it auto-fills the rest of the grammar with the first possible option.
 It's important to note that we assume that the prefix is of a completely valid string that adheres to the grammar, so there is no error handling!
 This is useful if you are streaming a long string, e.g. JSON, and you want to parse it as you receive it, meaning you'd want to complete that string in a minimal way.
+Parsers are immutable once constructed (a Reference once defined), and all parsing state lives in the (prefix, pos) of each call, so a grammar can be shared by any number of threads without locking, including on free-threaded CPython.
 '''
 
 
 class Parser:
     '''Base class for all parsers. A parser is a callable that takes a prefix and a position, and returns a completed prefix and latest consumed position.'''
+    __slots__ = ()
+
+    def _set(self, **fields):
+        for name, value in fields.items():
+            object.__setattr__(self, name, value)
+
+    def __setattr__(self, name, value):
+        raise AttributeError(f'{type(self).__name__} is immutable')
+
+    def __delattr__(self, name):
+        raise AttributeError(f'{type(self).__name__} is immutable')
+
     def min_len(self):
         return 1
     
@@ -14,12 +27,20 @@ class Parser:
         raise NotImplementedError
 
 class Reference(Parser):
-    '''A parser that references another parser. Useful for recursive structures.'''
-    def __init__(self, child):
-        self.child = child
+    '''A parser that references another parser, given now or once later via define(). Useful for recursive structures.
+    A recursive structure needs an explicit min_len, since computing it from the child would never terminate.'''
+    __slots__ = ('child', '_min_len')
+
+    def __init__(self, child=None, min_len=None):
+        self._set(child=child, _min_len=min_len)
+
+    def define(self, child):
+        if self.child is not None:
+            raise AttributeError('Reference is already defined')
+        self._set(child=child)
 
     def min_len(self):
-        return self.child.min_len()
+        return self.child.min_len() if self._min_len is None else self._min_len
     
     def matches(self, char):
         return self.child.matches(char)
@@ -29,8 +50,10 @@ class Reference(Parser):
 
 class Lit(Parser):
     '''A parser that matches a literal string of any length.'''
+    __slots__ = ('value',)
+
     def __init__(self, value):
-        self.value = value
+        self._set(value=value)
 
     def min_len(self):
         return len(self.value)
@@ -48,10 +71,10 @@ class Lit(Parser):
 
 class Range(Parser):
     '''A parser that matches a range of characters (ASCII).'''
+    __slots__ = ('start', 'end', 'default')
+
     def __init__(self, start, end, default=None):
-        self.start = start
-        self.end = end
-        self.default = start if default is None else default
+        self._set(start=start, end=end, default=start if default is None else default)
 
     def matches(self, char):
         return self.start <= char <= self.end
@@ -66,9 +89,10 @@ class Range(Parser):
 
 class Any(Parser):
     '''A parser that matches any character in a whitelist.'''
+    __slots__ = ('whitelist', 'default')
+
     def __init__(self, whitelist, default=None):
-        self.whitelist = whitelist
-        self.default = whitelist[0] if default is None else default
+        self._set(whitelist=frozenset(whitelist), default=whitelist[0] if default is None else default)
         
     def matches(self, char):
         return char in self.whitelist
@@ -83,9 +107,10 @@ class Any(Parser):
 
 class Except(Parser):
     '''A parser that matches any character not in a blacklist.'''
+    __slots__ = ('blacklist', 'default')
+
     def __init__(self, blacklist, default=None):
-        self.blacklist = blacklist
-        self.default = default if default is None else ''
+        self._set(blacklist=frozenset(blacklist), default='' if default is None else default)
 
     def matches(self, char):
         return char not in self.blacklist
@@ -100,8 +125,10 @@ class Except(Parser):
 
 class Opt(Parser):
     '''Makes the child parser optional.'''
+    __slots__ = ('child',)
+
     def __init__(self, child):
-        self.child = child
+        self._set(child=child)
 
     def min_len(self):
         return 0
@@ -116,8 +143,10 @@ class Opt(Parser):
 
 class Rep(Parser):
     '''Makes the child parser repeatable ANY number of times, including zero.'''
+    __slots__ = ('child',)
+
     def __init__(self, child):
-        self.child = child
+        self._set(child=child)
     
     def min_len(self):
         return 0
@@ -132,8 +161,10 @@ class Rep(Parser):
 
 class Or(Parser):
     '''Pick one of the children in order, and if none match, auto-fill first one.'''
+    __slots__ = ('children',)
+
     def __init__(self, *children):
-        self.children = children
+        self._set(children=children)
     
     def min_len(self):
         return min(child.min_len() for child in self.children)
@@ -151,8 +182,10 @@ class Or(Parser):
 
 class Seq(Parser):
     '''Run the children in order.'''
+    __slots__ = ('children',)
+
     def __init__(self, *children):
-        self.children = children
+        self._set(children=children)
 
     def min_len(self):
         return sum(child.min_len() for child in self.children)
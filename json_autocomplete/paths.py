@@ -0,0 +1,44 @@
+'''
+Paths select values inside a JSON document, for the features that act on parts of a stream.
+A path is the sequence of object keys and array indices leading to a value from the root, e.g. ('data', 0, 'embedding'), or the same written as a dotted string, 'data.0.embedding'.
+In patterns, '*' matches any single key or index, and a string component also matches the array index it spells.
+'''
+
+
+def parse_path(path):
+    '''Normalize a path or pattern given as a dotted string or a sequence to a tuple.'''
+    if isinstance(path, str):
+        return tuple(path.split('.')) if path else ()
+    return tuple(path)
+
+def component_matches(pattern, actual):
+    return pattern == '*' or pattern == actual or (isinstance(actual, int) and pattern == str(actual))
+
+def path_matches(pattern, path):
+    return len(pattern) == len(path) and all(component_matches(p, a) for p, a in zip(pattern, path))
+
+
+class PathSet:
+    '''A set of path patterns, matched against the live path of a Completer.'''
+    def __init__(self, patterns):
+        self.patterns = [parse_path(p) for p in ([patterns] if isinstance(patterns, str) else patterns)]
+        self._by_depth = {}
+        for pattern in self.patterns:
+            self._by_depth.setdefault(len(pattern), []).append(pattern)
+
+    def match(self, path):
+        for pattern in self._by_depth.get(len(path), ()):
+            if all(component_matches(p, a) for p, a in zip(pattern, path)):
+                return True
+        return False
+
+    def leads_to(self, path):
+        '''Whether some pattern matches a value strictly inside the one at `path`.'''
+        depth = len(path)
+        for pattern in self.patterns:
+            if len(pattern) > depth and all(component_matches(p, a) for p, a in zip(pattern, path)):
+                return True
+        return False
+
+    def __bool__(self):
+        return bool(self.patterns)
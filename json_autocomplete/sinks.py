@@ -0,0 +1,69 @@
+'''
+Sinks for large string fields.
+A Sink receives the decoded content of the string fields at some paths piece by piece as the document streams in, and writes it to a file or passes it to a callback, optionally decoding base64 on the way.
+The content is never held whole in memory: the document (see materialize.Builder) only gets a short preview of it.
+'''
+
+
+import binascii
+
+
+_WS = str.maketrans('', '', ' \t\n\r')
+
+
+class Sink:
+    '''Where the content of selected string fields goes: `target` is a writable file object (anything with write()) or a callable, given str pieces, or bytes ones with base64=True.
+    In the document, such a field holds its first `preview` characters followed by `placeholder`, or all of it if it is no longer than the preview.
+    All the fields a Sink is selected for are written to its target one after the other; `fields` counts them and `size` counts what was written.'''
+    def __init__(self, target, base64=False, preview=0, placeholder='…'):
+        self.write = target.write if hasattr(target, 'write') else target
+        self.base64 = base64
+        self.preview = preview
+        self.placeholder = placeholder
+        self.fields = 0
+        self.size = 0
+        self._head = ''     # the preview of the current field
+        self._length = 0    # characters of the current field so far
+        self._pending = ''  # base64 characters short of a 4-character group
+
+    def begin(self):
+        self._head = ''
+        self._length = 0
+        self._pending = ''
+
+    def feed(self, text):
+        '''Take the next piece of the current field. Returns whether placeholder_value() changed.'''
+        changed = bool(text) and self._length <= self.preview
+        if len(self._head) < self.preview:
+            self._head += text[:self.preview - len(self._head)]
+        self._length += len(text)
+        if self.base64:
+            text = self._pending + text.translate(_WS)
+            cut = len(text) - len(text) % 4
+            self._pending = text[cut:]
+            if not cut:
+                return changed
+            data = binascii.a2b_base64(text[:cut])
+        else:
+            data = text
+        if data:
+            self.write(data)
+            self.size += len(data)
+        return changed
+
+    def end(self):
+        '''Finish the current field (padding a truncated base64 tail, or dropping a lone character, which holds no whole byte), and return what the document holds in its place.'''
+        if len(self._pending) > 1:
+            data = binascii.a2b_base64(self._pending + '=' * (-len(self._pending) % 4))
+            if data:
+                self.write(data)
+                self.size += len(data)
+        self._pending = ''
+        self.fields += 1
+        return self.placeholder_value()
+
+    def placeholder_value(self):
+        '''What the document holds for the current field so far.'''
+        if self._length <= self.preview:
+            return self._head
+        return self._head + self.placeholder
@@ -0,0 +1,111 @@
+'''
+A structural index ("tape") of a JSON document, in the spirit of simdjson's: one flat array with an entry of three integers per value, recorded by incremental.Completer in the same pass as completion.
+Every entry is (type, offset, value), where type is the character code below, offset is where the value starts in the text, and value is:
+- for '{' and '[', the index of the entry after the matching '}' or ']' entry, so a whole container is skipped in one hop (0 while it is still open),
+- for '}' and ']', the index of the matching '{' or '[' entry,
+- for strings, numbers and literals, the length of their text (-1 while it is still being read).
+Object members are a string entry for the key followed by the entries of the value.
+Nothing is decoded: values are sliced from the text and decoded only when asked for.
+'''
+
+
+import json
+from array import array
+
+
+OBJECT = ord('{')
+OBJECT_END = ord('}')
+ARRAY = ord('[')
+ARRAY_END = ord(']')
+STRING = ord('"')
+NUMBER = ord('d')
+TRUE = ord('t')
+FALSE = ord('f')
+NULL = ord('n')
+
+_TYPES = {'"': STRING, 't': TRUE, 'f': FALSE, 'n': NULL}
+
+
+class Tape:
+    '''The tape of everything a Completer(tape=True) has been fed. Entries of unfinished values are updated as the rest arrives.'''
+    def __init__(self):
+        self.entries = array('q')
+        self._open = []     # entry index of every open container
+        self._pending = -1  # entry index of the string, number or literal being read
+
+    def __len__(self):
+        return len(self.entries) // 3
+
+    def clear(self):
+        del self.entries[:]
+        self._open = []
+        self._pending = -1
+
+    def type(self, i):
+        return self.entries[3 * i]
+
+    def offset(self, i):
+        return self.entries[3 * i + 1]
+
+    def entry(self, i):
+        return tuple(self.entries[3 * i:3 * i + 3])
+
+    def next(self, i):
+        '''The index of the entry after the value at i, including all of its contents.'''
+        entries = self.entries
+        if entries[3 * i] == OBJECT or entries[3 * i] == ARRAY:
+            return entries[3 * i + 2] or len(self)
+        return i + 1
+
+    def children(self, i):
+        '''The entry indices of the elements of the array at i, or of the keys and values (alternating) of the object at i.'''
+        end, j = self.next(i), i + 1
+        entries = self.entries
+        while j < end and entries[3 * j] != OBJECT_END and entries[3 * j] != ARRAY_END:
+            yield j
+            j = self.next(j)
+
+    def raw(self, text, i):
+        '''The text of the value at i, which must be complete.'''
+        kind, offset, value = self.entry(i)
+        if kind == OBJECT or kind == ARRAY:
+            if not value:
+                raise ValueError(f'the {chr(kind)} at {offset} is not closed yet')
+            return text[offset:self.offset(value - 1) + 1]
+        if value < 0:
+            raise ValueError(f'the value at {offset} is not complete yet')
+        return text[offset:offset + value]
+
+    def decode(self, text, i):
+        '''The value at i as Python objects, decoded from its text.'''
+        raw = self.raw(text, i)
+        kind = self.type(i)
+        if kind == STRING:
+            return json.loads(raw) if '\\' in raw else raw[1:-1]
+        if kind == NULL:
+            return None
+        if kind == TRUE or kind == FALSE:
+            return kind == TRUE
+        return json.loads(raw)
+
+    # Recording, called by the Completer
+
+    def _begin(self, char, offset):
+        self._pending = len(self)
+        self.entries.extend((_TYPES.get(char, NUMBER), offset, -1))
+
+    def _end(self, end):
+        i = 3 * self._pending
+        self.entries[i + 2] = end - self.entries[i + 1]
+
+    def _add(self, kind, offset, length):
+        self.entries.extend((kind, offset, length))
+
+    def _start(self, char, offset):
+        self._open.append(len(self))
+        self.entries.extend((ord(char), offset, 0))
+
+    def _finish(self, closer, offset):
+        start = self._open.pop()
+        self.entries.extend((ord(closer), offset, start))
+        self.entries[3 * start + 2] = len(self)
@@ -0,0 +1,159 @@
+'''
+Streaming transcoding to MessagePack.
+A MessagePackWriter is a Handler that encodes the values its Completer parses as they complete, so packed() can return the MessagePack encoding of the completed document at any point without json.loads or a full re-encoding.
+MessagePack prefixes every container with its length, so the containers still open are assembled when packed() is called; everything that is complete inside them was encoded once, when it was read, and is reused as is across updates.
+Only the value in progress and the headers of the open containers are encoded again.
+As with json.loads, a key repeated in an object keeps the position of its first occurrence with the value of its last one.
+'''
+
+
+from struct import pack
+
+from .incremental import Completer, Handler
+from .native import decode_number, decode_numbers
+
+
+def pack_int(n):
+    if 0 <= n < 0x80:
+        return bytes((n,))
+    if -0x20 <= n < 0:
+        return bytes((n & 0xff,))
+    if n >= 0:
+        if n <= 0xff:
+            return b'\xcc' + bytes((n,))
+        if n <= 0xffff:
+            return pack('>BH', 0xcd, n)
+        if n <= 0xffffffff:
+            return pack('>BI', 0xce, n)
+        if n <= 0xffffffffffffffff:
+            return pack('>BQ', 0xcf, n)
+    elif n >= -0x80:
+        return pack('>Bb', 0xd0, n)
+    elif n >= -0x8000:
+        return pack('>Bh', 0xd1, n)
+    elif n >= -0x80000000:
+        return pack('>Bi', 0xd2, n)
+    elif n >= -0x8000000000000000:
+        return pack('>Bq', 0xd3, n)
+    return pack_float(float(n)) # out of MessagePack's integer range
+
+def pack_float(x):
+    return pack('>Bd', 0xcb, x)
+
+def pack_number(value):
+    return pack_float(value) if value.__class__ is float else pack_int(value)
+
+def pack_str(text):
+    data = text.encode('utf-8', 'surrogatepass')
+    n = len(data)
+    if n < 32:
+        return bytes((0xa0 | n,)) + data
+    if n <= 0xff:
+        return b'\xd9' + bytes((n,)) + data
+    if n <= 0xffff:
+        return pack('>BH', 0xda, n) + data
+    return pack('>BI', 0xdb, n) + data
+
+def pack_header(count, is_object):
+    if count < 16:
+        return bytes(((0x80 if is_object else 0x90) | count,))
+    if count <= 0xffff:
+        return pack('>BH', 0xde if is_object else 0xdc, count)
+    return pack('>BI', 0xdf if is_object else 0xdd, count)
+
+
+class MessagePackWriter(Handler):
+    '''Transcodes a JSON stream to MessagePack: feed() it chunks of JSON, and packed() returns the encoding of the completed document so far.
+    Integers beyond 64 bits, which MessagePack cannot represent, are encoded as floats.'''
+    def __init__(self):
+        self.completer = Completer(self)
+        self.reset()
+
+    def reset(self):
+        self.completer.reset()
+        self._frames = []   # per open container: [encoded members (key and value together for objects), member count, whether it is an object, for objects {key: encoded member}]
+        self._string = []   # decoded pieces of the string value being read
+        self._done = None   # the encoding of the top-level value, once complete
+        self._closing = False
+
+    def feed(self, chunk):
+        self.completer.feed(chunk)
+
+    def packed(self) -> bytes:
+        '''The MessagePack encoding of the completed document, i.e. of json.loads(json_autocomplete(everything fed)).'''
+        if self._done is not None and not self._frames:
+            return self._done
+        for frame in self._frames:
+            if len(frame[0]) > 1:
+                frame[0][:] = [b''.join(frame[0])] # keep it joined for the next call
+        saved = ([[list(f[0]), f[1], f[2], f[3]] for f in self._frames], list(self._string), self._done)
+        self._closing = True # the member dicts are shared with `saved`, and must not change
+        self.completer.close_events()
+        self._closing = False
+        packed = self._done
+        self._frames, self._string, self._done = saved
+        return packed
+
+    def _put(self, path, data):
+        if not self._frames:
+            self._done = data
+            return
+        frame = self._frames[-1]
+        if frame[2]:
+            key, members = path[-1], frame[3]
+            data = pack_str(key) + data
+            if key in members:
+                # rare: re-assemble the members, the first occurrence's place now holding this value
+                if self._closing:
+                    members = dict(members)
+                members[key] = data
+                frame[0][:] = members.values()
+                return
+            if not self._closing:
+                members[key] = data
+        frame[0].append(data)
+        frame[1] += 1
+
+    def _start(self, is_object):
+        self._frames.append([[], 0, is_object, {} if is_object else None])
+
+    def _end(self, path):
+        parts, count, is_object, _ = self._frames.pop()
+        parts.insert(0, pack_header(count, is_object))
+        self._put(path, b''.join(parts))
+
+    def start_object(self, path):
+        self._start(True)
+
+    def start_array(self, path):
+        self._start(False)
+
+    def end_object(self, path):
+        self._end(path)
+
+    end_array = end_object
+
+    def string_chunk(self, path, text, last):
+        if not last:
+            self._string.append(text)
+        else:
+            if self._string:
+                self._string.append(text)
+                text = ''.join(self._string)
+                self._string = []
+            self._put(path, pack_str(text))
+
+    def number(self, path, text):
+        self._put(path, pack_number(decode_number(text)))
+
+    def numbers(self, path, text):
+        frame = self._frames[-1]
+        values = decode_numbers(text.split(',')[:-1])
+        frame[0] += map(pack_number, values)
+        frame[1] += len(values)
+
+    def bool(self, path, value):
+        self._put(path, b'\xc3' if value else b'\xc2')
+
+    def null(self, path):
+        self._put(path, b'\xc0')
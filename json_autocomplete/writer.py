@@ -0,0 +1,194 @@
+'''
+Rewriting a JSON stream on the fly.
+A Writer is a Handler that writes the document its Completer parses back out as compact JSON, chunk by chunk, changing it on the way: long arrays and strings are cut and nesting is capped for previews, only selected paths are kept for projections, and sensitive fields are masked.
+What feed() returns is stable (it never has to be taken back), and suffix() completes it into a valid document, from the parser's close events, in O(depth). Everything the Writer leaves out is skipped as it is parsed, and never built or serialized.
+'''
+
+
+import re
+from json.encoder import encode_basestring
+
+from .fingerprint import RunningHash
+from .incremental import Completer, Handler
+from .paths import PathSet
+
+
+_WS_RUN = re.compile(r'[ \t\n\r]+')
+
+
+class Writer(Handler):
+    '''Writes compact JSON for the document fed to it, bounded for previews:
+    - at most `max_items` elements per array, the rest replaced by one `marker` element,
+    - at most `max_string` characters per string, the rest replaced by `marker` at the end of the string,
+    - at most `max_depth` levels of nested containers, deeper ones replaced by `marker` (as a string).
+    With `select`, path patterns (see paths.py), only the values at those paths are written, with their containers on the way from the root; the top-level value is null if it is neither selected nor a container.
+    The values at the path patterns in `redact`, and of the object members named in `redact_keys` (at any depth), are written as `placeholder` (a string) instead.
+    With a `digest` (a hashlib algorithm name), the output is hashed as it is written, and fingerprint() is the hash of the current completed output.'''
+    def __init__(self, max_items=None, max_string=None, max_depth=None, marker='…', select=None, redact=(), redact_keys=(), placeholder='[REDACTED]', digest=None):
+        self.hash = RunningHash(digest) if digest else None
+        self.select = None if select is None else PathSet(select)
+        self.redact = PathSet(redact)
+        self.redact_keys = frozenset([redact_keys] if isinstance(redact_keys, str) else redact_keys)
+        self.placeholder = placeholder
+        self._placeholder_value = encode_basestring(placeholder)
+        self.max_items = max_items
+        self.max_string = max_string
+        self.max_depth = max_depth
+        self.marker = marker
+        self._marker_value = encode_basestring(marker)
+        self.completer = Completer(self)
+        self.reset()
+
+    def reset(self):
+        self.completer.reset()
+        if self.hash is not None:
+            self.hash.reset()
+        self._out = []
+        self._frames = []     # per container being written: [members written so far, whether it is an object, whether it is selected]
+        self._key = None      # the key of the next member, written along with its value
+        self._skip = None     # the depth of the container being left out, if any
+        self._in_string = False
+        self._written = 0     # characters of the current string written, -1 if it is left out, past max_string once cut
+
+    def feed(self, chunk) -> str:
+        '''Parse the next chunk, and return the output it adds.'''
+        self.completer.feed(chunk)
+        output = ''.join(self._out)
+        self._out = []
+        if self.hash is not None:
+            self.hash.update(output)
+        return output
+
+    def fingerprint(self) -> str:
+        return self.hash.fingerprint(self.suffix())
+
+    def suffix(self) -> str:
+        '''What completes the output so far into a valid document.'''
+        saved = ([list(frame) for frame in self._frames], self._key, self._skip, self._in_string, self._written)
+        self.completer.close_events()
+        suffix = ''.join(self._out)
+        self._out = []
+        self._frames, self._key, self._skip, self._in_string, self._written = saved
+        return suffix
+
+    def _begin(self, path, container=False):
+        '''Called at the start of every value: writes what goes before it, and returns whether to write the value itself.'''
+        if not path:
+            if self.redact and self.redact.match(path):
+                self._out.append(self._placeholder_value)
+                return False
+            if container or self.select is None or self.select.match(path):
+                return True
+            self._out.append('null')
+            return False
+        frame = self._frames[-1]
+        if not frame[2] and not self.select.match(path) and not (container and self.select.leads_to(path)):
+            return False
+        if not frame[1] and self.max_items is not None and path[-1] >= self.max_items:
+            if path[-1] == self.max_items:
+                self._separate(frame)
+                self._out.append(self._marker_value)
+            return False
+        self._separate(frame)
+        if (frame[1] and path[-1] in self.redact_keys) or (self.redact and self.redact.match(path)):
+            self._out.append(self._placeholder_value)
+            return False
+        return True
+
+    def _selected(self, path):
+        if self.select is None or (self._frames and self._frames[-1][2]):
+            return True
+        return self.select.match(path)
+
+    def _separate(self, frame):
+        if frame[0]:
+            self._out.append(',')
+        frame[0] += 1
+        if frame[1]:
+            self._out += (encode_basestring(self._key), ':')
+
+    def _start(self, path, opener, is_object):
+        if self._skip is not None:
+            return
+        if not self._begin(path, True):
+            self._skip = len(path)
+        elif self.max_depth is not None and len(path) >= self.max_depth:
+            self._out.append(self._marker_value)
+            self._skip = len(path)
+        else:
+            self._out.append(opener)
+            self._frames.append([0, is_object, self._selected(path)])
+
+    def _end(self, path, closer):
+        if self._skip is not None:
+            if len(path) == self._skip:
+                self._skip = None
+            return
+        self._frames.pop()
+        self._out.append(closer)
+
+    def start_object(self, path):
+        self._start(path, '{', True)
+
+    def start_array(self, path):
+        self._start(path, '[', False)
+
+    def end_object(self, path):
+        self._end(path, '}')
+
+    def end_array(self, path):
+        self._end(path, ']')
+
+    def key(self, path, name):
+        self._key = name
+
+    def _scalar(self, path, text):
+        if self._skip is None and self._begin(path):
+            self._out.append(text)
+
+    def number(self, path, text):
+        self._scalar(path, text)
+
+    def numbers(self, path, text):
+        if self._skip is not None:
+            return
+        count = text.count(',')
+        frame = self._frames[-1]
+        if not frame[2] or (self.redact and self.redact.leads_to(path[:-1])):
+            return super().numbers(path, text) # element by element, through _begin()
+        if self.max_items is not None and path[-1] + count > self.max_items:
+            if path[-1] <= self.max_items:
+                super().numbers(path, text)
+            return
+        if frame[0]:
+            self._out.append(',')
+        frame[0] += count
+        self._out.append(_WS_RUN.sub('', text)[:-1])
+
+    def bool(self, path, value):
+        self._scalar(path, 'true' if value else 'false')
+
+    def null(self, path):
+        self._scalar(path, 'null')
+
+    def string_chunk(self, path, text, last):
+        if self._skip is not None:
+            return
+        if not self._in_string:
+            self._in_string = True
+            self._written = 0 if self._begin(path) else -1
+            if self._written == 0:
+                self._out.append('"')
+        written = self._written
+        if written >= 0:
+            if self.max_string is not None and written + len(text) > self.max_string:
+                if written <= self.max_string:
+                    self._out += (encode_basestring(text[:self.max_string - written])[1:-1], self._marker_value[1:-1])
+                    self._written = self.max_string + 1
+            elif text:
+                self._out.append(encode_basestring(text)[1:-1])
+                self._written = written + len(text)
+            if last:
+                self._out.append('"')
+        if last:
+            self._in_string = False
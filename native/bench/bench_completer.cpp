@@ -0,0 +1,208 @@
+// Native engine benchmarks: one-shot completion, per-token streaming, string-heavy, number-heavy and deeply nested
+// documents, number decoding, and session creation/teardown.
+// Usage: bench_completer [filter...] [--min-time=seconds] [--repeats=n]
+
+#include "harness.hpp"
+
+#include "json_autocomplete/completer.hpp"
+#include "json_autocomplete/jac.h"
+#include "json_autocomplete/json_grammar.hpp"
+#include "json_autocomplete/number.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+// ---- documents, ~1 MB each ----
+
+constexpr std::size_t kSize = 1 << 20;
+
+std::string tool_calls() {
+    std::string doc = "[";
+    for (int i = 0; doc.size() < kSize; ++i) {
+        if (i)
+            doc += ",\n  ";
+        doc += R"({"name": "get_weather", "arguments": {"location": {"city": "Seoul", "lat": 37.5665, "lon": 126.978},)"
+               R"( "days": )" + std::to_string(i % 14) +
+               R"(, "include": ["hourly", "alerts"], "metric": true, "note": null, "query": "weather in \"Seoul\"\n"}})";
+    }
+    return doc + "]";
+}
+
+std::string strings() {
+    std::string doc = "[";
+    const std::string text = "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor. ";
+    while (doc.size() < kSize) {
+        if (doc.size() > 1)
+            doc += ", ";
+        doc += '"';
+        for (int i = 0; i < 50; ++i)
+            doc += text;
+        doc += R"(\né\")";
+        doc += '"';
+    }
+    return doc + "]";
+}
+
+std::string numbers() {
+    std::mt19937_64 rng(7);
+    std::string doc = "[";
+    for (int i = 0; doc.size() < kSize; ++i) {
+        if (i)
+            doc += ", ";
+        switch (i % 4) {
+        case 0: doc += std::to_string(rng() % 1000000); break;
+        case 1: doc += "-" + std::to_string(rng() % 100) + "." + std::to_string(rng() % 100000000); break;
+        case 2: doc += std::to_string(rng() % 10) + "." + std::to_string(rng() % 1000) + "e-" + std::to_string(rng() % 300); break;
+        default: doc += "0." + std::to_string(rng()); break;
+        }
+    }
+    return doc + "]";
+}
+
+// 256 levels deep, repeated; completing it costs O(depth) per token
+std::string nested() {
+    std::string level = R"({"a": [1, )";
+    std::string block;
+    std::string closers;
+    for (int depth = 0; depth < 128; ++depth) {
+        block += level;
+        closers += "]}";
+    }
+    block += "null" + closers;
+
+    std::string doc = "[";
+    while (doc.size() < kSize) {
+        if (doc.size() > 1)
+            doc += ", ";
+        doc += block;
+    }
+    return doc + "]";
+}
+
+// LLM-style tokens: chunks of 1 to 8 bytes
+std::vector<std::string_view> tokenize(const std::string& doc) {
+    std::mt19937 rng(1);
+    std::vector<std::string_view> tokens;
+    for (std::size_t pos = 0; pos < doc.size();) {
+        const std::size_t n = std::min<std::size_t>(1 + rng() % 8, doc.size() - pos);
+        tokens.push_back(std::string_view(doc).substr(pos, n));
+        pos += n;
+    }
+    return tokens;
+}
+
+struct Document {
+    const char* name;
+    std::string text;
+    std::vector<std::string_view> tokens;
+};
+
+std::vector<Document>& documents() {
+    static std::vector<Document> docs = [] {
+        std::vector<Document> d;
+        d.push_back({"tool_calls", tool_calls(), {}});
+        d.push_back({"strings", strings(), {}});
+        d.push_back({"numbers", numbers(), {}});
+        d.push_back({"nested", nested(), {}});
+        for (auto& doc : d) {
+            jac::Completer check;
+            if (!check.feed(doc.text) || !check.suffix().empty()) {
+                std::fprintf(stderr, "benchmark document %s is not valid JSON\n", doc.name);
+                std::abort();
+            }
+            doc.tokens = tokenize(doc.text);
+        }
+        return d;
+    }();
+    return docs;
+}
+
+void register_cases() {
+    static jac::Completer completer;
+
+    for (const Document& doc : documents()) {
+        const std::string name = doc.name;
+
+        bench::add("one_shot/" + name, doc.text.size(), 0, [&doc] {
+            completer.reset();
+            completer.feed(doc.text);
+            bench::do_not_optimize(completer.suffix().size());
+        });
+
+        // feed every token and ask for the completion after each one, as a streaming UI would
+        bench::add("stream/" + name, doc.text.size(), doc.tokens.size(), [&doc] {
+            completer.reset();
+            for (std::string_view token : doc.tokens) {
+                completer.feed(token);
+                bench::do_not_optimize(completer.suffix().size());
+            }
+        });
+    }
+
+    // the compile-time combinators re-parse the whole prefix, like json.py
+    static const std::string medium = documents()[0].text.substr(0, 64 * 1024);
+    bench::add("combinators/one_shot/tool_calls", medium.size(), 0, [] {
+        bench::do_not_optimize(jac::grammar::json::json_autocomplete(medium).size());
+    });
+
+    // decoding every number of the numbers document, against the standard library
+    static std::vector<std::string_view> number_texts;
+    static std::vector<std::string> number_strings; // NUL-terminated copies for strtod
+    static std::size_t number_bytes = 0;
+    {
+        std::string_view rest = std::string_view(documents()[2].text).substr(1);
+        while (!rest.empty()) {
+            const std::size_t stop = std::min(rest.find(','), rest.find(']'));
+            number_texts.push_back(rest.substr(0, stop));
+            number_strings.emplace_back(number_texts.back());
+            number_bytes += number_texts.back().size();
+            rest = rest.substr(std::min(stop + 2, rest.size()));
+        }
+    }
+    bench::add("numbers/parse_number", number_bytes, number_texts.size(), [] {
+        jac::Number number;
+        for (std::string_view text : number_texts) {
+            jac::parse_number(text, number);
+            bench::do_not_optimize(number.real);
+        }
+    });
+    bench::add("numbers/strtod", number_bytes, number_texts.size(), [] {
+        for (const std::string& text : number_strings)
+            bench::do_not_optimize(std::strtod(text.c_str(), nullptr));
+    });
+
+    bench::add("session/completer_new_delete", 0, 0, [] {
+        auto c = std::make_unique<jac::Completer>();
+        bench::do_not_optimize(c.get());
+    });
+    bench::add("session/jac_new_free", 0, 0, [] {
+        jac_session* s = jac_session_new();
+        bench::do_not_optimize(s);
+        jac_session_free(s);
+    });
+    bench::add("session/jac_new_feed_suffix_free", 0, 0, [] {
+        static const char chunk[] = R"({"name": "get_weather", "arguments": {"city": "Se)";
+        char out[64];
+        size_t length;
+        jac_session* s = jac_session_new();
+        jac_session_feed(s, chunk, sizeof chunk - 1);
+        jac_session_suffix(s, out, sizeof out, &length);
+        bench::do_not_optimize(out[0]);
+        jac_session_free(s);
+    });
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    register_cases();
+    return bench::run(argc, argv);
+}
@@ -0,0 +1,85 @@
+// Throughput of the scan kernels on long string bodies, and of the Completer on a string-heavy document.
+// Usage: bench_scan [megabytes]
+
+#include "json_autocomplete/completer.hpp"
+#include "scan.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+template <class F>
+double best_seconds(F&& run, int repeats = 5) {
+    double best = 1e30;
+    for (int r = 0; r < repeats; ++r) {
+        const auto start = Clock::now();
+        run();
+        const double s = std::chrono::duration<double>(Clock::now() - start).count();
+        if (s < best)
+            best = s;
+    }
+    return best;
+}
+
+// Printable text with an escape every ~4 KB, roughly what a generated file inside a tool call looks like.
+std::string string_body(std::size_t size) {
+    std::string body;
+    body.reserve(size);
+    const char* words = "the quick brown fox jumps over the lazy dog 0123456789 ";
+    for (std::size_t i = 0; body.size() < size; ++i) {
+        body += words;
+        if (i % 64 == 63)
+            body += "\\n";
+    }
+    body.resize(size);
+    if (body.back() == '\\')
+        body.back() = '.';
+    return body;
+}
+
+volatile std::size_t sink;
+
+void bench_kernel(const jac::scan::Kernels& k, const std::string& body) {
+    const double s = best_seconds([&] {
+        std::size_t total = 0;
+        const char* p = body.data();
+        std::size_t n = body.size();
+        while (n > 0) {
+            const std::size_t run = k.string_run(p, n);
+            total += run;
+            const std::size_t skip = run < n ? run + 1 : n; // step over the byte that ended the run
+            p += skip;
+            n -= skip;
+        }
+        sink = total;
+    });
+    std::printf("string_run %-9s %8.2f GB/s\n", k.name, body.size() / s / 1e9);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t megabytes = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 64;
+    const std::string body = string_body(megabytes << 20);
+
+    bench_kernel(jac::scan::portable(), body);
+    if (const auto* k = jac::scan::sse2())
+        bench_kernel(*k, body);
+    if (const auto* k = jac::scan::avx2())
+        bench_kernel(*k, body);
+
+    const std::string doc = "{\"content\": \"" + body + "\"}";
+    jac::Completer completer;
+    const double s = best_seconds([&] {
+        completer.reset();
+        completer.feed(doc);
+        sink = completer.suffix().size();
+    });
+    std::printf("Completer::feed (%s) %8.2f GB/s\n", jac::scan::best().name, doc.size() / s / 1e9);
+    return completer.failed() ? 1 : 0;
+}
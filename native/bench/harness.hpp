@@ -0,0 +1,108 @@
+/*
+Minimal self-contained benchmark harness, so the benchmarks build without fetching anything.
+
+    bench::add("name", bytes_per_op, tokens_per_op, [&] { ... one operation ... });
+    return bench::run(argc, argv);
+
+Each case is calibrated to run for at least --min-time seconds (default 0.5), measured --repeats times (default 3)
+and reported by its best run, as ns/op plus throughput in bytes/s and ns/token when those are given.
+Any other argument selects the cases whose name contains it.
+*/
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace bench {
+
+struct Case {
+    std::string name;
+    std::size_t bytes;  // per operation, 0 if not meaningful
+    std::size_t tokens; // per operation, 0 if not meaningful
+    std::function<void()> op;
+};
+
+inline std::vector<Case>& registry() {
+    static std::vector<Case> cases;
+    return cases;
+}
+
+inline void add(std::string name, std::size_t bytes, std::size_t tokens, std::function<void()> op) {
+    registry().push_back({std::move(name), bytes, tokens, std::move(op)});
+}
+
+// Keeps the compiler from optimizing a result away.
+template <class T>
+inline void do_not_optimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+inline double seconds_for(const Case& c, std::size_t iterations) {
+    using Clock = std::chrono::steady_clock;
+    const auto start = Clock::now();
+    for (std::size_t i = 0; i < iterations; ++i)
+        c.op();
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+inline void print_rate(double per_second, const char* unit) {
+    if (per_second >= 1e9)
+        std::printf("  %8.2f G%s/s", per_second / 1e9, unit);
+    else
+        std::printf("  %8.2f M%s/s", per_second / 1e6, unit);
+}
+
+inline int run(int argc, char** argv) {
+    double min_time = 0.5;
+    int repeats = 3;
+    std::vector<const char*> filters;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--min-time=", 11) == 0)
+            min_time = std::atof(argv[i] + 11);
+        else if (std::strncmp(argv[i], "--repeats=", 10) == 0)
+            repeats = std::atoi(argv[i] + 10);
+        else
+            filters.push_back(argv[i]);
+    }
+
+    for (const Case& c : registry()) {
+        bool selected = filters.empty();
+        for (const char* f : filters)
+            selected = selected || c.name.find(f) != std::string::npos;
+        if (!selected)
+            continue;
+
+        std::size_t iterations = 1;
+        while (seconds_for(c, iterations) < min_time / 10)
+            iterations *= 2;
+        iterations = static_cast<std::size_t>(iterations * 10 * 1.1);
+        double best = 1e300;
+        for (int r = 0; r < repeats; ++r) {
+            const double per_op = seconds_for(c, iterations) / iterations;
+            best = per_op < best ? per_op : best;
+        }
+
+        std::printf("%-32s %12.1f ns/op", c.name.c_str(), best * 1e9);
+        if (c.bytes)
+            print_rate(c.bytes / best, "B");
+        if (c.tokens)
+            std::printf("  %8.1f ns/token", best * 1e9 / c.tokens);
+        std::printf("\n");
+        std::fflush(stdout);
+    }
+    return 0;
+}
+
+} // namespace bench
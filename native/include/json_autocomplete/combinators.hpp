@@ -0,0 +1,258 @@
+/*
+Header-only, compile-time counterpart of json_autocomplete/parser.py.
+
+Every combinator of parser.py is a class template here, and a grammar is a type built from them, e.g.
+
+    using Digit = Seq<Range<'0', '9'>, Rep<Range<'0', '9'>>>;
+
+The semantics are those of parser.py: consume the prefix char by char, pick branches (Or, Opt, Rep) by the single
+next character, and once the prefix is exhausted, auto-fill the first possible option. What parser.py computes at
+runtime through matches() and min_len() is computed here with constexpr: each combinator has a FIRST set (the
+characters its matches() accepts) and a min_len, so every branch decision compiles to a bitset test against a
+constant and the whole grammar is instantiated into plain, specialized functions without any virtual calls.
+
+Recursive structures use Ref<Rule>, where Rule is a struct declared before use and defined later:
+
+    struct Value;
+    using Array = Seq<Lit<'['>, Opt<Seq<Ref<Value>, Rep<Seq<Lit<','>, Ref<Value>>>>>>, Lit<']'>>;
+    struct Value { using type = Or<Lit<'0'>, Array>; static constexpr std::size_t min_len = 1; };
+
+Like the min_len lambdas assigned in json.py, Rule::min_len is optional but required to break the cycle whenever
+the min_len of a recursive rule depends on itself.
+*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace jac::grammar {
+
+// A set of bytes, used as the FIRST set of a parser.
+struct CharSet {
+    std::uint64_t words[4] = {0, 0, 0, 0};
+
+    constexpr bool test(char c) const {
+        const auto b = static_cast<unsigned char>(c);
+        return (words[b >> 6] >> (b & 63)) & 1;
+    }
+
+    constexpr CharSet& add(char c) {
+        const auto b = static_cast<unsigned char>(c);
+        words[b >> 6] |= std::uint64_t{1} << (b & 63);
+        return *this;
+    }
+
+    constexpr CharSet& add_range(char lo, char hi) {
+        for (int b = static_cast<unsigned char>(lo); b <= static_cast<unsigned char>(hi); ++b)
+            add(static_cast<char>(b));
+        return *this;
+    }
+
+    static constexpr CharSet all() {
+        CharSet s;
+        for (auto& w : s.words)
+            w = ~std::uint64_t{0};
+        return s;
+    }
+
+    constexpr CharSet operator|(const CharSet& other) const {
+        CharSet s;
+        for (int i = 0; i < 4; ++i)
+            s.words[i] = words[i] | other.words[i];
+        return s;
+    }
+
+    constexpr CharSet operator~() const {
+        CharSet s;
+        for (int i = 0; i < 4; ++i)
+            s.words[i] = ~words[i];
+        return s;
+    }
+};
+
+// Parsing state shared by all combinators: the prefix, the position in the (virtually) completed string and the
+// auto-filled characters appended past the end of the prefix so far.
+struct Cursor {
+    std::string_view prefix;
+    std::size_t pos = 0;
+    std::string filled;
+
+    bool at_end() const { return pos >= prefix.size(); }
+    char peek() const { return prefix[pos]; }
+};
+
+namespace detail {
+
+template <class P>
+constexpr bool matches(char c) {
+    constexpr CharSet first = P::first();
+    return first.test(c);
+}
+
+template <class P, class... Rest>
+constexpr CharSet seq_first() {
+    // a child with min_len 0 may be skipped, so the next one can also start the sequence
+    if constexpr (sizeof...(Rest) > 0 && P::min_len() == 0)
+        return P::first() | seq_first<Rest...>();
+    else
+        return P::first();
+}
+
+template <class Rule, class = void>
+struct rule_min_len {
+    static constexpr std::size_t value = Rule::type::min_len();
+};
+
+template <class Rule>
+struct rule_min_len<Rule, std::void_t<decltype(Rule::min_len)>> {
+    static constexpr std::size_t value = Rule::min_len;
+};
+
+} // namespace detail
+
+// Parser that references a rule defined later. Useful for recursive structures.
+template <class Rule>
+struct Ref {
+    static constexpr std::size_t min_len() { return detail::rule_min_len<Rule>::value; }
+    static constexpr CharSet first() { return Rule::type::first(); }
+    static void parse(Cursor& cur) { Rule::type::parse(cur); }
+};
+
+// Parser that matches a literal string of any length.
+template <char C, char... Cs>
+struct Lit {
+    static constexpr std::size_t min_len() { return 1 + sizeof...(Cs); }
+    static constexpr CharSet first() { return CharSet{}.add(C); }
+
+    static void parse(Cursor& cur) {
+        for (char c : {C, Cs...}) {
+            if (cur.at_end())
+                cur.filled += c; // missing char, auto-insert it!
+            ++cur.pos;
+        }
+    }
+};
+
+// Parser that matches a range of characters (ASCII).
+template <char Lo, char Hi, char Default = Lo>
+struct Range {
+    static constexpr std::size_t min_len() { return 1; }
+    static constexpr CharSet first() { return CharSet{}.add_range(Lo, Hi); }
+
+    static void parse(Cursor& cur) {
+        if (cur.at_end())
+            cur.filled += Default;
+        ++cur.pos;
+    }
+};
+
+// Parser that matches any character in a whitelist, auto-filling the first one.
+template <char C, char... Cs>
+struct Any {
+    static constexpr std::size_t min_len() { return 1; }
+    static constexpr CharSet first() { return (CharSet{}.add(C) | ... | CharSet{}.add(Cs)); }
+
+    static void parse(Cursor& cur) {
+        if (cur.at_end())
+            cur.filled += C;
+        ++cur.pos;
+    }
+};
+
+// Parser that matches any character not in a blacklist. There is no sensible default, so nothing is auto-filled.
+template <char... Cs>
+struct Except {
+    static constexpr std::size_t min_len() { return 1; }
+    static constexpr CharSet first() { return ~(CharSet{} | ... | CharSet{}.add(Cs)); }
+
+    static void parse(Cursor& cur) {
+        if (!cur.at_end())
+            ++cur.pos;
+    }
+};
+
+// Makes the child parser optional.
+template <class P>
+struct Opt {
+    static constexpr std::size_t min_len() { return 0; }
+    static constexpr CharSet first() { return P::first(); }
+
+    static void parse(Cursor& cur) {
+        if (!cur.at_end() && detail::matches<P>(cur.peek()))
+            P::parse(cur);
+    }
+};
+
+// Makes the child parser repeatable ANY number of times, including zero.
+template <class P>
+struct Rep {
+    static constexpr std::size_t min_len() { return 0; }
+    // as in parser.py, a repetition claims to match anything
+    static constexpr CharSet first() { return CharSet::all(); }
+
+    static void parse(Cursor& cur) {
+        while (!cur.at_end() && detail::matches<P>(cur.peek()))
+            P::parse(cur);
+    }
+};
+
+// Pick one of the children in order, and if none match, auto-fill first one.
+template <class P, class... Ps>
+struct Or {
+    static constexpr std::size_t min_len() {
+        std::size_t n = P::min_len();
+        ((n = Ps::min_len() < n ? Ps::min_len() : n), ...);
+        return n;
+    }
+    static constexpr CharSet first() { return (P::first() | ... | Ps::first()); }
+
+    static void parse(Cursor& cur) {
+        if (!cur.at_end()) {
+            const char c = cur.peek();
+            const bool taken = (try_parse<P>(cur, c) || ... || try_parse<Ps>(cur, c));
+            if (taken)
+                return;
+        }
+        // no child matched, auto-insert first one
+        P::parse(cur);
+    }
+
+private:
+    template <class Child>
+    static bool try_parse(Cursor& cur, char c) {
+        if (!detail::matches<Child>(c))
+            return false;
+        Child::parse(cur);
+        return true;
+    }
+};
+
+// Run the children in order.
+template <class... Ps>
+struct Seq {
+    static constexpr std::size_t min_len() { return (Ps::min_len() + ... + 0); }
+    static constexpr CharSet first() { return detail::seq_first<Ps...>(); }
+
+    static void parse(Cursor& cur) { (Ps::parse(cur), ...); }
+};
+
+// Complete a prefix of the grammar G in a minimal way. Returns only what has to be appended to the prefix.
+template <class G>
+std::string complete_suffix(std::string_view prefix) {
+    Cursor cur{prefix, 0, {}};
+    G::parse(cur);
+    return std::move(cur.filled);
+}
+
+// Complete a prefix of the grammar G in a minimal way. Returns the completed string.
+template <class G>
+std::string complete(std::string_view prefix) {
+    std::string completed(prefix);
+    completed += complete_suffix<G>(prefix);
+    return completed;
+}
+
+} // namespace jac::grammar
@@ -0,0 +1,86 @@
+/*
+Incremental counterpart of json_autocomplete/json.py.
+
+The Python reference re-parses the whole prefix on every call. The Completer below walks the exact same grammar,
+but as an explicit state machine over a stack of open containers, so that a stream can be fed chunk by chunk and
+the minimal completion (the "suffix" that json.py would append) can be produced at any point in O(depth).
+As in the reference, the input is assumed to be a prefix of a valid JSON document; on anything else the completer
+enters a sticky error state instead of guessing.
+*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace jac {
+
+namespace scan {
+struct Kernels;
+}
+
+class Completer {
+public:
+    Completer();
+
+    // Consume the next chunk of the document. Returns false (and stays failed until reset()) if the chunk cannot
+    // continue a valid JSON prefix.
+    bool feed(std::string_view chunk);
+
+    // The shortest string that turns everything fed so far into a valid JSON document, i.e. what json.py appends.
+    // The view stays valid until the next call to feed(), suffix() or reset().
+    std::string_view suffix();
+
+    // Forget the current document but keep the allocated buffers, so a Completer can be reused across streams.
+    void reset();
+
+    // Give back buffer memory beyond what a document nested max_depth levels deep needs.
+    void shrink_to(std::size_t max_depth);
+
+    bool failed() const { return state_ == State::Error; }
+    std::size_t depth() const { return stack_.size(); }
+    std::uint64_t consumed() const { return consumed_; }
+
+private:
+    enum class State : std::uint8_t {
+        Value,        // expecting a value (top level, after ':' or after ',' in an array)
+        ArrayFirst,   // after '[': a value or ']'
+        ObjectFirst,  // after '{': a key or '}'
+        Key,          // after ',' in an object: a key
+        KeyString,    // inside a key
+        KeyEscape,    // after '\' inside a key
+        KeyUnicode,   // inside "\uXXXX" in a key, hex_ digits seen
+        Colon,        // after a key: ':'
+        String,       // inside a string value
+        Escape,       // after '\' inside a string value
+        Unicode,      // inside "\uXXXX" in a string value, hex_ digits seen
+        Literal,      // inside null/true/false, literal_[literal_pos_] is next
+        NumMinus,     // after '-'
+        NumZero,      // after a leading '0'
+        NumInt,       // inside the integer part
+        NumDot,       // after '.'
+        NumFrac,      // inside the fraction
+        NumExp,       // after 'e' / 'E'
+        NumExpSign,   // after the exponent sign
+        NumExpDigits, // inside the exponent
+        AfterValue,   // a value just ended: ',', a closing bracket or whitespace
+        Error,
+    };
+
+    bool step(char c);
+    bool begin_value(char c);
+    void end_value();
+
+    const scan::Kernels* scan_;
+    State state_;
+    std::uint8_t hex_;
+    std::uint8_t literal_pos_;
+    const char* literal_;
+    std::uint64_t consumed_;
+    std::vector<char> stack_;  // closing bracket of every open container, innermost last
+    std::string suffix_;
+};
+
+} // namespace jac
@@ -0,0 +1,96 @@
+/*
+Plain C interface to jac::Completer, for loading libjson_autocomplete through FFI (Go, Rust, Lua, ctypes, ...).
+
+    jac_session* s = jac_session_new();
+    jac_session_feed(s, chunk, chunk_len);   // as many times as needed
+    char out[256];
+    size_t len;
+    if (jac_session_suffix(s, out, sizeof out, &len) == JAC_OK)
+        ...                                   // out[0..len) completes everything fed so far
+    jac_session_free(s);
+
+Sessions come from a process-wide pool: jac_session_free() hands the session, including its grown buffers, back
+for the next jac_session_new() instead of returning it to malloc. All functions are thread-safe as long as a single
+session is not used by two threads at once, and none of them calls back into the caller, so FFI layers can drop
+their interpreter locks around every call.
+*/
+#ifndef JSON_AUTOCOMPLETE_JAC_H
+#define JSON_AUTOCOMPLETE_JAC_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct jac_session jac_session;
+
+enum {
+    JAC_OK = 0,
+    JAC_ERR_SYNTAX = -1, /* the input is not a prefix of a valid JSON document */
+    JAC_ERR_BUFFER = -2, /* the output buffer is too small, the required length is reported */
+    JAC_ERR_MEMORY = -3,
+};
+
+/* Upper bound of the completion of a prefix of the given length. */
+#define JAC_SUFFIX_BOUND(length) ((length) + 8)
+
+/* Returns NULL if out of memory. */
+jac_session* jac_session_new(void);
+
+/* Consume the next chunk. After JAC_ERR_SYNTAX the session stays failed until jac_session_reset(). */
+int jac_session_feed(jac_session* session, const char* data, size_t length);
+
+/* Write the completion of everything fed so far into out. *length always receives the length of the completion;
+   nothing is written (and JAC_ERR_BUFFER returned) if it exceeds capacity. The output is not NUL-terminated. */
+int jac_session_suffix(jac_session* session, char* out, size_t capacity, size_t* length);
+
+/* Start a new document, keeping the session's buffers. */
+void jac_session_reset(jac_session* session);
+
+/* Return the session to the pool. NULL is ignored. */
+void jac_session_free(jac_session* session);
+
+/* Batches run on internal worker threads, using up to `threads` of them (0: one per CPU), the calling thread
+   included. Small batches stay on the calling thread. Per-item results go to statuses[i]; the return value is
+   JAC_OK unless the batch could not run at all. */
+
+/* Complete count independent prefixes. The completion of prefix i is written to out at offset
+   sum(JAC_SUFFIX_BOUND(lengths[j]) for j < i) and its length to suffix_lengths[i], so capacity must be at least
+   the sum over all prefixes (JAC_ERR_BUFFER otherwise, nothing is done). */
+int jac_complete_many(size_t count, const char* const* prefixes, const size_t* lengths, char* out, size_t capacity,
+                      size_t* suffix_lengths, int* statuses, size_t threads);
+
+/* Feed chunks[i] to sessions[i], as jac_session_feed would. The sessions must be distinct. */
+int jac_feed_many(size_t count, jac_session* const* sessions, const char* const* chunks, const size_t* lengths,
+                  int* statuses, size_t threads);
+
+/* Numbers, decoded the way jac::parse_number does (number.hpp): correctly rounded, and number prefixes such as
+   "2." or "1e" completed the way json.py completes them. */
+
+enum {
+    JAC_NUMBER_INT = 0,     /* integer in the int64 range: `integer` */
+    JAC_NUMBER_FLOAT = 1,   /* fraction and/or exponent: `real` */
+    JAC_NUMBER_BIG_INT = 2, /* integer outside the int64 range: only the approximation in `real` */
+};
+
+typedef struct jac_number {
+    int kind;
+    long long integer;
+    double real; /* set for every kind */
+} jac_number;
+
+int jac_parse_number(const char* text, size_t length, jac_number* out);
+
+/* Decode up to count numbers from text, where they are separated by single `separator` bytes and optionally
+   surrounded by JSON whitespace. The kind, integer and real value of number i go to kinds[i], integers[i] and
+   reals[i]; any of the three arrays may be NULL. Returns how many numbers were decoded, which is less than count
+   only if the text ends early or number [return value] is invalid. */
+size_t jac_parse_numbers(const char* text, size_t length, char separator, size_t count, unsigned char* kinds,
+                         long long* integers, double* reals);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* JSON_AUTOCOMPLETE_JAC_H */
@@ -0,0 +1,130 @@
+/*
+The grammar of json_autocomplete/json.py, written with the compile-time combinators from combinators.hpp.
+See json.py for why the grammar is shaped the way it is (whitespace handling, single-character branching).
+*/
+#pragma once
+
+#include "json_autocomplete/combinators.hpp"
+
+namespace jac::grammar::json {
+
+using WS = Rep<Any<' ', '\n', '\r', '\t'>>;
+
+using Digit = Seq<Range<'0', '9'>, Rep<Range<'0', '9'>>>;
+using Number = Seq<
+    Opt<Lit<'-'>>, // if missing, skip
+    Or< // Pick one of the following in order, and if none match, auto-fill first one
+        Lit<'0'>,
+        Seq<
+            Range<'1', '9'>,
+            Rep<Range<'0', '9'>>
+        >
+    >,
+    Opt<Seq<
+        Lit<'.'>,
+        Digit
+    >>,
+    Opt<Seq<
+        Or<
+            Lit<'e'>,
+            Lit<'E'>
+        >,
+        Opt<Or<
+            Lit<'+'>,
+            Lit<'-'>
+        >>,
+        Digit
+    >>
+>;
+
+using HexDigit = Or<
+    Range<'0', '9'>,
+    Range<'a', 'f'>,
+    Range<'A', 'F'>
+>;
+using Unicode = Seq<Lit<'u'>, HexDigit, HexDigit, HexDigit, HexDigit>;
+using String = Seq<
+    Lit<'"'>,
+    Rep<Or<
+        Except<'"', '\\'>,
+        Seq<
+            Lit<'\\'>,
+            Or<
+                Any<'"', '\\', '/', 'b', 'f', 'n', 'r', 't'>,
+                Unicode
+            >
+        >
+    >>,
+    Lit<'"'>
+>;
+
+// Forward references for recursive structures
+struct Value;
+struct Object;
+struct Array;
+
+using KeyValue = Seq<
+    String, WS,
+    Lit<':'>, WS,
+    Ref<Value>
+>;
+using MemberList = Seq<
+    KeyValue,
+    Rep<Seq<
+        Lit<','>, WS,
+        KeyValue
+    >>
+>;
+using ValueList = Seq<
+    Ref<Value>,
+    Rep<Seq<
+        Lit<','>, WS,
+        Ref<Value>
+    >>
+>;
+
+struct Value {
+    using type = Seq<
+        Or<
+            Lit<'n', 'u', 'l', 'l'>,
+            String,
+            Number,
+            Ref<Object>,
+            Ref<Array>,
+            Lit<'t', 'r', 'u', 'e'>,
+            Lit<'f', 'a', 'l', 's', 'e'>
+        >,
+        WS
+    >;
+    static constexpr std::size_t min_len = 1;
+};
+
+struct Object {
+    using type = Seq<
+        Lit<'{'>, WS,
+        Opt<MemberList>,
+        Lit<'}'>
+    >;
+    static constexpr std::size_t min_len = 2;
+};
+
+struct Array {
+    using type = Seq<
+        Lit<'['>, WS,
+        Opt<ValueList>,
+        Lit<']'>
+    >;
+    static constexpr std::size_t min_len = 2;
+};
+
+using WSValue = Seq<WS, Ref<Value>>;
+
+static_assert(Number::min_len() == 1 && Number::first().test('-') && !Number::first().test('+'));
+static_assert(Ref<Value>::first().test('{') && !Ref<Value>::first().test(' '));
+
+// Autocomplete any prefix of a JSON string in a minimal way. Returns the completed string.
+inline std::string json_autocomplete(std::string_view prefix) {
+    return complete<WSValue>(prefix);
+}
+
+} // namespace jac::grammar::json
@@ -0,0 +1,32 @@
+/*
+Decoding of the number text matched by json.py's Number into a value, without going through strtod for the common
+cases: integers are accumulated directly, and floats are correctly rounded with Clinger's fast path or, failing
+that, the Eisel-Lemire algorithm (falling back to the standard library only for inputs with more than 19
+significant digits and other very rare cases).
+
+Prefixes of numbers are decoded as if completed the way json.py completes them: "" and "-" are (-)0, "2." is 2.0,
+"1e" and "1e-" are 1e0.
+*/
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+namespace jac {
+
+enum class NumberKind : std::uint8_t {
+    Integer,    // no fraction or exponent, fits in an int64: `integer` holds it
+    Float,      // `real` holds the correctly rounded double
+    BigInteger, // no fraction or exponent, but outside the int64 range: only `real` (an approximation) is set
+};
+
+struct Number {
+    NumberKind kind;
+    std::int64_t integer;
+    double real; // set for every kind
+};
+
+// Returns false if text is not a (prefix of a) JSON number.
+bool parse_number(std::string_view text, Number& out);
+
+} // namespace jac
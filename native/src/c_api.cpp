@@ -0,0 +1,173 @@
+#include "json_autocomplete/jac.h"
+
+#include "json_autocomplete/number.hpp"
+
+#include "session_pool.hpp"
+#include "worker_pool.hpp"
+
+#include <cstring>
+#include <new>
+#include <vector>
+
+using jac::Completer;
+using jac::SessionPool;
+using jac::WorkerPool;
+
+namespace {
+
+// Below this many bytes per thread, handing work to another thread costs more than it saves.
+constexpr std::size_t kMinBytesPerThread = 64 * 1024;
+
+Completer* unwrap(jac_session* session) {
+    return reinterpret_cast<Completer*>(session);
+}
+
+inline bool is_ws(char c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+std::size_t batch_threads(std::size_t threads, const size_t* lengths, std::size_t count) {
+    std::size_t total = 0;
+    for (std::size_t i = 0; i < count; ++i)
+        total += lengths[i];
+    const std::size_t useful = total / kMinBytesPerThread;
+    if (useful <= 1)
+        return 1;
+    return threads == 0 || threads > useful ? useful : threads;
+}
+
+} // namespace
+
+extern "C" {
+
+jac_session* jac_session_new(void) {
+    try {
+        return reinterpret_cast<jac_session*>(SessionPool::instance().acquire());
+    } catch (const std::bad_alloc&) {
+        return nullptr;
+    }
+}
+
+int jac_session_feed(jac_session* session, const char* data, size_t length) {
+    try {
+        return unwrap(session)->feed({data, length}) ? JAC_OK : JAC_ERR_SYNTAX;
+    } catch (const std::bad_alloc&) {
+        return JAC_ERR_MEMORY;
+    }
+}
+
+int jac_session_suffix(jac_session* session, char* out, size_t capacity, size_t* length) {
+    Completer* completer = unwrap(session);
+    *length = 0;
+    if (completer->failed())
+        return JAC_ERR_SYNTAX;
+    try {
+        const std::string_view suffix = completer->suffix();
+        *length = suffix.size();
+        if (suffix.size() > capacity)
+            return JAC_ERR_BUFFER;
+        if (!suffix.empty())
+            std::memcpy(out, suffix.data(), suffix.size());
+        return JAC_OK;
+    } catch (const std::bad_alloc&) {
+        return JAC_ERR_MEMORY;
+    }
+}
+
+void jac_session_reset(jac_session* session) {
+    unwrap(session)->reset();
+}
+
+void jac_session_free(jac_session* session) {
+    if (session)
+        SessionPool::instance().release(unwrap(session));
+}
+
+int jac_complete_many(size_t count, const char* const* prefixes, const size_t* lengths, char* out, size_t capacity,
+                      size_t* suffix_lengths, int* statuses, size_t threads) {
+    try {
+        std::vector<std::size_t> offsets(count);
+        std::size_t required = 0;
+        for (std::size_t i = 0; i < count; ++i) {
+            offsets[i] = required;
+            required += JAC_SUFFIX_BOUND(lengths[i]);
+        }
+        if (required > capacity)
+            return JAC_ERR_BUFFER;
+
+        WorkerPool::instance().parallel_for(count, batch_threads(threads, lengths, count), [&](std::size_t i) {
+            thread_local Completer completer;
+            completer.reset();
+            suffix_lengths[i] = 0;
+            statuses[i] = JAC_ERR_SYNTAX;
+            try {
+                if (!completer.feed({prefixes[i], lengths[i]}))
+                    return;
+                const std::string_view suffix = completer.suffix();
+                std::memcpy(out + offsets[i], suffix.data(), suffix.size());
+                suffix_lengths[i] = suffix.size();
+                statuses[i] = JAC_OK;
+            } catch (const std::bad_alloc&) {
+                statuses[i] = JAC_ERR_MEMORY;
+            }
+        });
+        return JAC_OK;
+    } catch (const std::exception&) {
+        return JAC_ERR_MEMORY; // the offsets, or starting a worker thread
+    }
+}
+
+int jac_feed_many(size_t count, jac_session* const* sessions, const char* const* chunks, const size_t* lengths,
+                  int* statuses, size_t threads) {
+    try {
+        WorkerPool::instance().parallel_for(count, batch_threads(threads, lengths, count), [&](std::size_t i) {
+            statuses[i] = jac_session_feed(sessions[i], chunks[i], lengths[i]);
+        });
+        return JAC_OK;
+    } catch (const std::exception&) {
+        return JAC_ERR_MEMORY;
+    }
+}
+
+int jac_parse_number(const char* text, size_t length, jac_number* out) {
+    jac::Number number;
+    if (!jac::parse_number({text, length}, number))
+        return JAC_ERR_SYNTAX;
+    out->kind = static_cast<int>(number.kind);
+    out->integer = number.integer;
+    out->real = number.real;
+    return JAC_OK;
+}
+
+size_t jac_parse_numbers(const char* text, size_t length, char separator, size_t count, unsigned char* kinds,
+                         long long* integers, double* reals) {
+    const char* p = text;
+    const char* const end = text + length;
+    for (std::size_t i = 0; i < count; ++i) {
+        if (i > 0) {
+            if (p == end)
+                return i;
+            ++p; // the separator
+        }
+        while (p != end && is_ws(*p))
+            ++p;
+        const char* const begin = p;
+        while (p != end && *p != separator && !is_ws(*p))
+            ++p;
+        const char* const stop = p;
+        while (p != end && is_ws(*p))
+            ++p;
+        jac::Number number;
+        if ((p != end && *p != separator) || !jac::parse_number({begin, static_cast<std::size_t>(stop - begin)}, number))
+            return i;
+        if (kinds)
+            kinds[i] = static_cast<unsigned char>(number.kind);
+        if (integers)
+            integers[i] = number.integer;
+        if (reals)
+            reals[i] = number.real;
+    }
+    return count;
+}
+
+} // extern "C"
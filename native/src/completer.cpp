@@ -0,0 +1,307 @@
+#include "json_autocomplete/completer.hpp"
+
+#include "scan.hpp"
+
+namespace jac {
+
+namespace {
+
+// Initial capacities; they are only ever grown, never shrunk, so a reused Completer stops allocating once it has
+// seen its deepest document.
+constexpr std::size_t kInitialDepth = 64;
+constexpr std::size_t kMaxTail = 10; // longest state tail in suffix(), '0000":null' right after \u in a key
+
+inline bool is_ws(char c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+inline bool is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+inline bool is_hex(char c) {
+    return is_digit(c) || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+inline bool is_escape(char c) {
+    switch (c) {
+    case '"': case '\\': case '/': case 'b': case 'f': case 'n': case 'r': case 't':
+        return true;
+    default:
+        return false;
+    }
+}
+
+} // namespace
+
+Completer::Completer() : scan_(&scan::best()) {
+    stack_.reserve(kInitialDepth);
+    suffix_.reserve(kInitialDepth + kMaxTail);
+    reset();
+}
+
+void Completer::reset() {
+    state_ = State::Value;
+    hex_ = 0;
+    literal_pos_ = 0;
+    literal_ = nullptr;
+    consumed_ = 0;
+    stack_.clear();
+    suffix_.clear();
+}
+
+void Completer::shrink_to(std::size_t max_depth) {
+    if (stack_.capacity() > max_depth && stack_.size() <= max_depth) {
+        std::vector<char> stack;
+        stack.reserve(max_depth);
+        stack.assign(stack_.begin(), stack_.end());
+        stack_.swap(stack);
+    }
+    if (suffix_.capacity() > max_depth + kMaxTail) {
+        std::string suffix;
+        suffix.reserve(max_depth + kMaxTail);
+        suffix_.swap(suffix);
+    }
+}
+
+bool Completer::feed(std::string_view chunk) {
+    if (state_ == State::Error)
+        return false;
+    const char* p = chunk.data();
+    const std::size_t n = chunk.size();
+    for (std::size_t i = 0; i < n; ++i) {
+        // Skip the long runs (string bodies, indentation, digits) in bulk; step() sees only the byte that ends them.
+        switch (state_) {
+        case State::String:
+        case State::KeyString:
+            i += scan_->string_run(p + i, n - i);
+            break;
+        case State::Value:
+        case State::ArrayFirst:
+        case State::ObjectFirst:
+        case State::Key:
+        case State::Colon:
+        case State::AfterValue:
+            if (is_ws(p[i]))
+                i += scan_->whitespace_run(p + i, n - i);
+            break;
+        case State::NumInt:
+        case State::NumFrac:
+        case State::NumExpDigits:
+            i += scan_->digit_run(p + i, n - i);
+            break;
+        default:
+            break;
+        }
+        if (i == n)
+            break;
+        if (!step(p[i])) {
+            state_ = State::Error;
+            return false;
+        }
+    }
+    consumed_ += n;
+    return true;
+}
+
+void Completer::end_value() {
+    state_ = State::AfterValue;
+}
+
+// Same dispatch as the Or() inside json.py's Value, decided by the first character alone.
+bool Completer::begin_value(char c) {
+    switch (c) {
+    case 'n': literal_ = "null"; break;
+    case 't': literal_ = "true"; break;
+    case 'f': literal_ = "false"; break;
+    case '"': state_ = State::String; return true;
+    case '-': state_ = State::NumMinus; return true;
+    case '0': state_ = State::NumZero; return true;
+    case '{': stack_.push_back('}'); state_ = State::ObjectFirst; return true;
+    case '[': stack_.push_back(']'); state_ = State::ArrayFirst; return true;
+    default:
+        if (c >= '1' && c <= '9') {
+            state_ = State::NumInt;
+            return true;
+        }
+        return false;
+    }
+    literal_pos_ = 1;
+    state_ = State::Literal;
+    return true;
+}
+
+bool Completer::step(char c) {
+    switch (state_) {
+    case State::Value:
+        return is_ws(c) || begin_value(c);
+
+    case State::ArrayFirst:
+        if (is_ws(c))
+            return true;
+        if (c == ']') {
+            stack_.pop_back();
+            end_value();
+            return true;
+        }
+        return begin_value(c);
+
+    case State::ObjectFirst:
+        if (c == '}') {
+            stack_.pop_back();
+            end_value();
+            return true;
+        }
+        [[fallthrough]];
+    case State::Key:
+        if (c == '"') {
+            state_ = State::KeyString;
+            return true;
+        }
+        return is_ws(c);
+
+    case State::KeyString:
+        if (c == '"')
+            state_ = State::Colon;
+        else if (c == '\\')
+            state_ = State::KeyEscape;
+        return true;
+
+    case State::KeyEscape:
+    case State::Escape: {
+        const bool key = state_ == State::KeyEscape;
+        if (c == 'u') {
+            hex_ = 0;
+            state_ = key ? State::KeyUnicode : State::Unicode;
+            return true;
+        }
+        state_ = key ? State::KeyString : State::String;
+        return is_escape(c);
+    }
+
+    case State::KeyUnicode:
+    case State::Unicode:
+        if (!is_hex(c))
+            return false;
+        if (++hex_ == 4)
+            state_ = state_ == State::KeyUnicode ? State::KeyString : State::String;
+        return true;
+
+    case State::Colon:
+        if (c == ':') {
+            state_ = State::Value;
+            return true;
+        }
+        return is_ws(c);
+
+    case State::String:
+        if (c == '"')
+            end_value();
+        else if (c == '\\')
+            state_ = State::Escape;
+        return true;
+
+    case State::Literal:
+        if (c != literal_[literal_pos_])
+            return false;
+        if (literal_[++literal_pos_] == '\0')
+            end_value();
+        return true;
+
+    case State::NumMinus:
+        if (c == '0')
+            state_ = State::NumZero;
+        else if (c >= '1' && c <= '9')
+            state_ = State::NumInt;
+        else
+            return false;
+        return true;
+
+    case State::NumInt:
+        if (is_digit(c))
+            return true;
+        [[fallthrough]];
+    case State::NumZero:
+        if (c == '.') {
+            state_ = State::NumDot;
+            return true;
+        }
+        [[fallthrough]];
+    case State::NumFrac:
+        if (state_ == State::NumFrac && is_digit(c))
+            return true;
+        if (c == 'e' || c == 'E') {
+            state_ = State::NumExp;
+            return true;
+        }
+        // the number is over, the character belongs to whatever follows it
+        end_value();
+        return step(c);
+
+    case State::NumDot:
+        state_ = State::NumFrac;
+        return is_digit(c);
+
+    case State::NumExp:
+        if (c == '+' || c == '-') {
+            state_ = State::NumExpSign;
+            return true;
+        }
+        [[fallthrough]];
+    case State::NumExpSign:
+        state_ = State::NumExpDigits;
+        return is_digit(c);
+
+    case State::NumExpDigits:
+        if (is_digit(c))
+            return true;
+        end_value();
+        return step(c);
+
+    case State::AfterValue:
+        if (is_ws(c))
+            return true;
+        if (stack_.empty())
+            return false; // only whitespace may follow the top-level value
+        if (c == ',') {
+            state_ = stack_.back() == '}' ? State::Key : State::Value;
+            return true;
+        }
+        if (c != stack_.back())
+            return false;
+        stack_.pop_back();
+        end_value();
+        return true;
+
+    case State::Error:
+        return false;
+    }
+    return false;
+}
+
+std::string_view Completer::suffix() {
+    suffix_.clear();
+    switch (state_) {
+    case State::Value:        suffix_ += "null"; break;
+    case State::Key:          suffix_ += "\"\":null"; break;
+    case State::KeyString:    suffix_ += "\":null"; break;
+    case State::KeyEscape:    suffix_ += "\"\":null"; break;
+    case State::KeyUnicode:   suffix_.append(4 - hex_, '0'); suffix_ += "\":null"; break;
+    case State::Colon:        suffix_ += ":null"; break;
+    case State::String:       suffix_ += '"'; break;
+    case State::Escape:       suffix_ += "\"\""; break;
+    case State::Unicode:      suffix_.append(4 - hex_, '0'); suffix_ += '"'; break;
+    case State::Literal:      suffix_ += literal_ + literal_pos_; break;
+    case State::NumMinus:
+    case State::NumDot:
+    case State::NumExp:
+    case State::NumExpSign:   suffix_ += '0'; break;
+    case State::Error:        return {};
+    default:                  break;
+    }
+    for (auto it = stack_.rbegin(); it != stack_.rend(); ++it)
+        suffix_ += *it;
+    return suffix_;
+}
+
+} // namespace jac
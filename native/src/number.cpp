@@ -0,0 +1,275 @@
+#include "json_autocomplete/number.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+
+#if __has_include(<charconv>)
+#include <charconv>
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+namespace jac {
+
+namespace {
+
+constexpr int kSmallestPowerOfFive = -342;
+constexpr int kLargestPowerOfFive = 308;
+
+// {high, low} 64 bits of 5^q, normalized to 128 bits, for q in [kSmallestPowerOfFive, kLargestPowerOfFive]
+constexpr std::uint64_t kPowersOfFive[][2] = {
+#include "powers_of_five.inc"
+};
+
+constexpr double kExactPowersOfTen[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+inline bool is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+struct U128 {
+    std::uint64_t low;
+    std::uint64_t high;
+};
+
+inline U128 multiply(std::uint64_t a, std::uint64_t b) {
+#if defined(__SIZEOF_INT128__)
+    __extension__ typedef unsigned __int128 uint128;
+    const uint128 r = static_cast<uint128>(a) * b;
+    return {static_cast<std::uint64_t>(r), static_cast<std::uint64_t>(r >> 64)};
+#elif defined(_MSC_VER) && !defined(__clang__) && defined(_M_X64)
+    std::uint64_t high;
+    const std::uint64_t low = _umul128(a, b, &high);
+    return {low, high};
+#else
+    const std::uint64_t a_lo = a & 0xFFFFFFFF, a_hi = a >> 32, b_lo = b & 0xFFFFFFFF, b_hi = b >> 32;
+    const std::uint64_t lo_lo = a_lo * b_lo, hi_lo = a_hi * b_lo, lo_hi = a_lo * b_hi, hi_hi = a_hi * b_hi;
+    const std::uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFF) + lo_hi;
+    return {(cross << 32) | (lo_lo & 0xFFFFFFFF), (hi_lo >> 32) + (cross >> 32) + hi_hi};
+#endif
+}
+
+inline int leading_zeros(std::uint64_t x) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long i;
+    _BitScanReverse64(&i, x);
+    return 63 - static_cast<int>(i);
+#else
+    return __builtin_clzll(x);
+#endif
+}
+
+inline double from_bits(std::uint64_t bits) {
+    double d;
+    std::memcpy(&d, &bits, sizeof d);
+    return d;
+}
+
+inline double signed_zero(bool negative) {
+    return negative ? -0.0 : 0.0;
+}
+
+inline double signed_infinity(bool negative) {
+    return negative ? -std::numeric_limits<double>::infinity() : std::numeric_limits<double>::infinity();
+}
+
+// Eisel-Lemire: the double nearest to w * 10^q, for w != 0 of at most 19 digits. Returns false in the (provably
+// rare) cases where the 128-bit approximation cannot decide the rounding.
+bool eisel_lemire(std::uint64_t w, std::int64_t q, bool negative, double& out) {
+    if (q < kSmallestPowerOfFive) {
+        out = signed_zero(negative);
+        return true;
+    }
+    if (q > kLargestPowerOfFive) {
+        out = signed_infinity(negative);
+        return true;
+    }
+
+    const int lz = leading_zeros(w);
+    w <<= lz;
+    const std::uint64_t* power = kPowersOfFive[q - kSmallestPowerOfFive];
+    U128 product = multiply(w, power[0]);
+    constexpr std::uint64_t kPrecisionMask = ~std::uint64_t{0} >> 55; // 52 mantissa bits + 3
+    if ((product.high & kPrecisionMask) == kPrecisionMask) {
+        const U128 second = multiply(w, power[1]);
+        product.low += second.high;
+        if (second.high > product.low)
+            ++product.high;
+    }
+    if (product.low == ~std::uint64_t{0} && (q < -27 || q > 55))
+        return false;
+
+    const int upper_bit = static_cast<int>(product.high >> 63);
+    std::uint64_t mantissa = product.high >> (upper_bit + 64 - 52 - 3);
+    std::int64_t power2 = (((152170 + 65536) * q) >> 16) + 63 + upper_bit - lz + 1023;
+
+    const std::uint64_t sign = negative ? std::uint64_t{1} << 63 : 0;
+    if (power2 <= 0) { // subnormal
+        if (-power2 + 1 >= 64) {
+            out = signed_zero(negative);
+            return true;
+        }
+        mantissa >>= -power2 + 1;
+        mantissa += mantissa & 1;
+        mantissa >>= 1;
+        power2 = mantissa < (std::uint64_t{1} << 52) ? 0 : 1;
+        out = from_bits(sign | mantissa | (static_cast<std::uint64_t>(power2) << 52));
+        return true;
+    }
+
+    // exactly halfway between two doubles: round to even
+    if (product.low <= 1 && q >= -4 && q <= 23 && (mantissa & 3) == 1 &&
+        (mantissa << (upper_bit + 64 - 52 - 3)) == product.high)
+        mantissa &= ~std::uint64_t{1};
+
+    mantissa += mantissa & 1;
+    mantissa >>= 1;
+    if (mantissa >= (std::uint64_t{2} << 52)) {
+        mantissa = std::uint64_t{1} << 52;
+        ++power2;
+    }
+    mantissa &= ~(std::uint64_t{1} << 52);
+    if (power2 >= 0x7FF) {
+        out = signed_infinity(negative);
+        return true;
+    }
+    out = from_bits(sign | mantissa | (static_cast<std::uint64_t>(power2) << 52));
+    return true;
+}
+
+// Slow path through the standard library, on the completed text.
+double parse_slow(std::string_view text) {
+    std::string completed(text);
+    if (completed.empty() || !is_digit(completed.back()))
+        completed += '0';
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    double value = 0;
+    const char* first = completed.data();
+    const auto result = std::from_chars(first, first + completed.size(), value);
+    if (result.ec == std::errc::result_out_of_range) // from_chars leaves value untouched on overflow/underflow
+        return std::strtod(completed.c_str(), nullptr);
+    return value;
+#else
+    return std::strtod(completed.c_str(), nullptr);
+#endif
+}
+
+} // namespace
+
+bool parse_number(std::string_view text, Number& out) {
+    const char* p = text.data();
+    const char* const end = p + text.size();
+
+    const bool negative = p != end && *p == '-';
+    if (negative)
+        ++p;
+
+    // integer part; missing digits are only allowed at the end of the prefix, where json.py would fill in a 0
+    const char* const int_begin = p;
+    if (p != end && *p == '0')
+        ++p;
+    else
+        while (p != end && is_digit(*p))
+            ++p;
+    const char* const int_end = p;
+    if (int_begin == int_end && p != end)
+        return false;
+
+    bool is_float = false;
+    const char* frac_begin = p;
+    const char* frac_end = p;
+    if (p != end && *p == '.') {
+        is_float = true;
+        frac_begin = ++p;
+        while (p != end && is_digit(*p))
+            ++p;
+        frac_end = p;
+        if (frac_begin == frac_end && p != end)
+            return false;
+    }
+
+    std::int64_t exponent = 0;
+    if (p != end && (*p == 'e' || *p == 'E')) {
+        is_float = true;
+        ++p;
+        bool exponent_negative = false;
+        if (p != end && (*p == '+' || *p == '-'))
+            exponent_negative = *p++ == '-';
+        const char* const exp_begin = p;
+        for (; p != end && is_digit(*p); ++p) {
+            if (exponent < 100000) // anything beyond is zero or infinity anyway
+                exponent = exponent * 10 + (*p - '0');
+        }
+        if (exp_begin == p && p != end)
+            return false;
+        if (exponent_negative)
+            exponent = -exponent;
+    }
+    if (p != end)
+        return false;
+
+    if (!is_float) {
+        const std::size_t digits = static_cast<std::size_t>(int_end - int_begin);
+        if (digits <= 19) {
+            std::uint64_t magnitude = 0;
+            for (const char* d = int_begin; d != int_end; ++d)
+                magnitude = magnitude * 10 + static_cast<std::uint64_t>(*d - '0');
+            const std::uint64_t limit = negative ? std::uint64_t{1} << 63 : (std::uint64_t{1} << 63) - 1;
+            if (magnitude <= limit) {
+                out.kind = NumberKind::Integer;
+                out.integer = negative ? static_cast<std::int64_t>(0 - magnitude) : static_cast<std::int64_t>(magnitude);
+                out.real = static_cast<double>(out.integer);
+                return true;
+            }
+        }
+        out.kind = NumberKind::BigInteger;
+        out.integer = 0;
+        out.real = parse_slow(text);
+        return true;
+    }
+
+    out.kind = NumberKind::Float;
+    out.integer = 0;
+
+    // significant digits w, with the value being w * 10^q
+    std::uint64_t w = 0;
+    int significant = 0;
+    auto accumulate = [&](const char* begin, const char* stop) {
+        for (const char* d = begin; d != stop; ++d) {
+            if (significant == 0 && *d == '0')
+                continue; // leading zeros
+            if (++significant <= 19)
+                w = w * 10 + static_cast<std::uint64_t>(*d - '0');
+        }
+    };
+    accumulate(int_begin, int_end);
+    accumulate(frac_begin, frac_end);
+    if (significant > 19) {
+        out.real = parse_slow(text);
+        return true;
+    }
+    const std::int64_t q = exponent - static_cast<std::int64_t>(frac_end - frac_begin);
+
+    if (w == 0) {
+        out.real = signed_zero(negative);
+        return true;
+    }
+    if (w <= (std::uint64_t{1} << 53) && q >= -22 && q <= 22) { // Clinger: both operands exact, one rounding
+        double value = static_cast<double>(w);
+        value = q < 0 ? value / kExactPowersOfTen[-q] : value * kExactPowersOfTen[q];
+        out.real = negative ? -value : value;
+        return true;
+    }
+    if (!eisel_lemire(w, q, negative, out.real))
+        out.real = parse_slow(text);
+    return true;
+}
+
+} // namespace jac
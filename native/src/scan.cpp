@@ -0,0 +1,240 @@
+#include "scan.hpp"
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define JAC_SCAN_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define JAC_TARGET_AVX2
+#else
+#define JAC_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace jac::scan {
+
+namespace {
+
+inline unsigned count_trailing_zeros(std::uint64_t x) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long i;
+    _BitScanForward64(&i, x);
+    return static_cast<unsigned>(i);
+#else
+    return static_cast<unsigned>(__builtin_ctzll(x));
+#endif
+}
+
+inline bool is_ws(char c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+inline bool is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+// ---- portable ----
+
+constexpr std::uint64_t kOnes = 0x0101010101010101ull;
+constexpr std::uint64_t kHighs = 0x8080808080808080ull;
+
+// High bit set in every byte of x that is zero. Bytes above the first zero byte may be false positives, which is
+// fine since only the lowest one is ever used.
+inline std::uint64_t zero_bytes(std::uint64_t x) {
+    return (x - kOnes) & ~x & kHighs;
+}
+
+inline bool little_endian() {
+    const std::uint16_t probe = 1;
+    unsigned char first;
+    std::memcpy(&first, &probe, 1);
+    return first == 1;
+}
+
+std::size_t string_run_portable(const char* p, std::size_t n) {
+    std::size_t i = 0;
+    if (little_endian()) {
+        for (; i + 8 <= n; i += 8) {
+            std::uint64_t word;
+            std::memcpy(&word, p + i, 8);
+            const std::uint64_t hits = zero_bytes(word ^ (kOnes * '"')) | zero_bytes(word ^ (kOnes * '\\'));
+            if (hits)
+                return i + count_trailing_zeros(hits) / 8;
+        }
+    }
+    for (; i < n; ++i) {
+        if (p[i] == '"' || p[i] == '\\')
+            return i;
+    }
+    return n;
+}
+
+std::size_t whitespace_run_portable(const char* p, std::size_t n) {
+    std::size_t i = 0;
+    while (i < n && is_ws(p[i]))
+        ++i;
+    return i;
+}
+
+std::size_t digit_run_portable(const char* p, std::size_t n) {
+    std::size_t i = 0;
+    while (i < n && is_digit(p[i]))
+        ++i;
+    return i;
+}
+
+#ifdef JAC_SCAN_X86
+
+// ---- SSE2, 16 bytes per step ----
+
+std::size_t string_run_sse2(const char* p, std::size_t n) {
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+        const __m128i hits = _mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, backslash));
+        const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(hits));
+        if (mask)
+            return i + count_trailing_zeros(mask);
+    }
+    return i + string_run_portable(p + i, n - i);
+}
+
+std::size_t whitespace_run_sse2(const char* p, std::size_t n) {
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i newline = _mm_set1_epi8('\n');
+    const __m128i cr = _mm_set1_epi8('\r');
+    const __m128i tab = _mm_set1_epi8('\t');
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+        const __m128i ws = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(v, space), _mm_cmpeq_epi8(v, newline)),
+            _mm_or_si128(_mm_cmpeq_epi8(v, cr), _mm_cmpeq_epi8(v, tab)));
+        const unsigned mask = ~static_cast<unsigned>(_mm_movemask_epi8(ws)) & 0xFFFFu;
+        if (mask)
+            return i + count_trailing_zeros(mask);
+    }
+    return i + whitespace_run_portable(p + i, n - i);
+}
+
+std::size_t digit_run_sse2(const char* p, std::size_t n) {
+    // signed compares: bytes >= 0x80 are negative and never digits
+    const __m128i below = _mm_set1_epi8('0' - 1);
+    const __m128i above = _mm_set1_epi8('9' + 1);
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+        const __m128i digits = _mm_and_si128(_mm_cmpgt_epi8(v, below), _mm_cmpgt_epi8(above, v));
+        const unsigned mask = ~static_cast<unsigned>(_mm_movemask_epi8(digits)) & 0xFFFFu;
+        if (mask)
+            return i + count_trailing_zeros(mask);
+    }
+    return i + digit_run_portable(p + i, n - i);
+}
+
+// ---- AVX2, 32 bytes per step ----
+
+JAC_TARGET_AVX2 std::size_t string_run_avx2(const char* p, std::size_t n) {
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    std::size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+        const __m256i hits = _mm256_or_si256(_mm256_cmpeq_epi8(v, quote), _mm256_cmpeq_epi8(v, backslash));
+        const auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(hits));
+        if (mask)
+            return i + count_trailing_zeros(mask);
+    }
+    return i + string_run_sse2(p + i, n - i);
+}
+
+JAC_TARGET_AVX2 std::size_t whitespace_run_avx2(const char* p, std::size_t n) {
+    const __m256i space = _mm256_set1_epi8(' ');
+    const __m256i newline = _mm256_set1_epi8('\n');
+    const __m256i cr = _mm256_set1_epi8('\r');
+    const __m256i tab = _mm256_set1_epi8('\t');
+    std::size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+        const __m256i ws = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, space), _mm256_cmpeq_epi8(v, newline)),
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, cr), _mm256_cmpeq_epi8(v, tab)));
+        const auto mask = ~static_cast<std::uint32_t>(_mm256_movemask_epi8(ws));
+        if (mask)
+            return i + count_trailing_zeros(mask);
+    }
+    return i + whitespace_run_sse2(p + i, n - i);
+}
+
+JAC_TARGET_AVX2 std::size_t digit_run_avx2(const char* p, std::size_t n) {
+    const __m256i below = _mm256_set1_epi8('0' - 1);
+    const __m256i above = _mm256_set1_epi8('9' + 1);
+    std::size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+        const __m256i digits = _mm256_and_si256(_mm256_cmpgt_epi8(v, below), _mm256_cmpgt_epi8(above, v));
+        const auto mask = ~static_cast<std::uint32_t>(_mm256_movemask_epi8(digits));
+        if (mask)
+            return i + count_trailing_zeros(mask);
+    }
+    return i + digit_run_sse2(p + i, n - i);
+}
+
+bool cpu_has_avx2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int regs[4];
+    __cpuid(regs, 0);
+    if (regs[0] < 7)
+        return false;
+    __cpuid(regs, 1);
+    const bool osxsave = (regs[2] & (1 << 27)) != 0;
+    if (!osxsave || (_xgetbv(0) & 0x6) != 0x6)
+        return false;
+    __cpuidex(regs, 7, 0);
+    return (regs[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+constexpr Kernels kSse2{"sse2", string_run_sse2, whitespace_run_sse2, digit_run_sse2};
+constexpr Kernels kAvx2{"avx2", string_run_avx2, whitespace_run_avx2, digit_run_avx2};
+
+#endif // JAC_SCAN_X86
+
+constexpr Kernels kPortable{"portable", string_run_portable, whitespace_run_portable, digit_run_portable};
+
+} // namespace
+
+const Kernels& portable() {
+    return kPortable;
+}
+
+const Kernels* sse2() {
+#ifdef JAC_SCAN_X86
+    return &kSse2;
+#else
+    return nullptr;
+#endif
+}
+
+const Kernels* avx2() {
+#ifdef JAC_SCAN_X86
+    static const bool supported = cpu_has_avx2();
+    return supported ? &kAvx2 : nullptr;
+#else
+    return nullptr;
+#endif
+}
+
+const Kernels& best() {
+    static const Kernels& kernels = avx2() ? *avx2() : sse2() ? *sse2() : portable();
+    return kernels;
+}
+
+} // namespace jac::scan
@@ -0,0 +1,34 @@
+/*
+Vectorized scanning of the runs that make up most of a JSON document: string bodies, whitespace and digits.
+Each kernel returns the length of the run at the start of [p, p + n), i.e. the index of the first byte that the
+Completer has to look at individually, or n if the whole range is part of the run.
+
+The portable kernels work on any target (SWAR for strings, scalar otherwise). On x86-64, SSE2 (16 bytes per step)
+is always available and AVX2 (32 bytes per step) is used when the CPU supports it; best() picks once at runtime.
+*/
+#pragma once
+
+#include <cstddef>
+
+namespace jac::scan {
+
+struct Kernels {
+    const char* name;
+    // bytes before the first '"' or '\' (json.py's String accepts every other byte, control characters included)
+    std::size_t (*string_run)(const char* p, std::size_t n);
+    // bytes before the first byte that is not ' ', '\n', '\r' or '\t'
+    std::size_t (*whitespace_run)(const char* p, std::size_t n);
+    // bytes before the first byte that is not '0'..'9'
+    std::size_t (*digit_run)(const char* p, std::size_t n);
+};
+
+const Kernels& portable();
+
+// nullptr when the kernels are not compiled in or not supported by this CPU
+const Kernels* sse2();
+const Kernels* avx2();
+
+// The fastest kernels supported by this CPU, resolved on first use.
+const Kernels& best();
+
+} // namespace jac::scan
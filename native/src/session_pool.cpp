@@ -0,0 +1,33 @@
+#include "session_pool.hpp"
+
+namespace jac {
+
+SessionPool& SessionPool::instance() {
+    // never destroyed, sessions may still be released from other threads during exit
+    static SessionPool* pool = new SessionPool();
+    return *pool;
+}
+
+Completer* SessionPool::acquire() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (free_.empty()) {
+        auto slab = std::make_unique<Completer[]>(kSlabSize);
+        free_.reserve((slabs_.size() + 1) * kSlabSize);
+        slabs_.reserve(slabs_.size() + 1);
+        for (std::size_t i = kSlabSize; i-- > 0;)
+            free_.push_back(&slab[i]);
+        slabs_.push_back(std::move(slab));
+    }
+    Completer* completer = free_.back();
+    free_.pop_back();
+    return completer;
+}
+
+void SessionPool::release(Completer* completer) {
+    completer->reset();
+    completer->shrink_to(kMaxRetainedDepth);
+    std::lock_guard<std::mutex> lock(mutex_);
+    free_.push_back(completer); // cannot throw, capacity for every slot was reserved in acquire()
+}
+
+} // namespace jac
@@ -0,0 +1,34 @@
+/*
+Process-wide pool of Completers backing the C sessions. Completers are allocated in slabs and recycled through a
+free list, so short-lived sessions neither construct nor allocate anything once the pool is warm; a recycled
+Completer keeps its stack and suffix buffers (trimmed to kMaxRetainedDepth).
+*/
+#pragma once
+
+#include "json_autocomplete/completer.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace jac {
+
+class SessionPool {
+public:
+    static constexpr std::size_t kSlabSize = 64;
+    static constexpr std::size_t kMaxRetainedDepth = 1024;
+
+    static SessionPool& instance();
+
+    // Throws std::bad_alloc.
+    Completer* acquire();
+    void release(Completer* completer);
+
+private:
+    std::mutex mutex_;
+    std::vector<std::unique_ptr<Completer[]>> slabs_;
+    std::vector<Completer*> free_;
+};
+
+} // namespace jac
@@ -0,0 +1,86 @@
+#include "worker_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+
+namespace jac {
+
+struct WorkerPool::Batch {
+    const std::function<void(std::size_t)>& fn;
+    std::size_t count;
+    std::size_t grain;
+    std::size_t helpers; // helpers still wanted; the batch leaves the queue when it reaches 0
+    std::size_t active;  // helpers currently running it, guarded by the pool's mutex
+    std::atomic<std::size_t> next;
+};
+
+WorkerPool& WorkerPool::instance() {
+    // never destroyed, the workers just block until the process exits
+    static WorkerPool* pool = new WorkerPool();
+    return *pool;
+}
+
+WorkerPool::WorkerPool() {
+    const unsigned hardware = std::thread::hardware_concurrency();
+    const std::size_t helpers = hardware > 1 ? hardware - 1 : 0;
+    workers_.reserve(helpers);
+    for (std::size_t i = 0; i < helpers; ++i)
+        workers_.emplace_back([this] { work(); });
+}
+
+void WorkerPool::run(Batch& batch) {
+    for (;;) {
+        const std::size_t begin = batch.next.fetch_add(batch.grain, std::memory_order_relaxed);
+        if (begin >= batch.count)
+            return;
+        const std::size_t end = std::min(begin + batch.grain, batch.count);
+        for (std::size_t i = begin; i < end; ++i)
+            batch.fn(i);
+    }
+}
+
+void WorkerPool::work() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        wake_.wait(lock, [this] { return !queue_.empty(); });
+        Batch& batch = *queue_.front();
+        if (--batch.helpers == 0)
+            queue_.pop_front();
+        ++batch.active;
+        lock.unlock();
+        run(batch);
+        lock.lock();
+        if (--batch.active == 0)
+            done_.notify_all();
+    }
+}
+
+void WorkerPool::parallel_for(std::size_t count, std::size_t threads, const std::function<void(std::size_t)>& fn) {
+    if (threads == 0 || threads > concurrency())
+        threads = concurrency();
+    if (threads > count)
+        threads = count;
+    if (threads <= 1) {
+        for (std::size_t i = 0; i < count; ++i)
+            fn(i);
+        return;
+    }
+
+    // a few blocks per thread balances uneven items without contending on the counter
+    Batch batch{fn, count, std::max<std::size_t>(1, count / (threads * 8)), threads - 1, 0, {0}};
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.push_back(&batch);
+    }
+    wake_.notify_all();
+
+    run(batch);
+
+    // every item is claimed now; make sure no helper picks the batch up late, then wait for the running ones
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (batch.helpers > 0)
+        queue_.erase(std::find(queue_.begin(), queue_.end(), &batch));
+    done_.wait(lock, [&] { return batch.active == 0; });
+}
+
+} // namespace jac
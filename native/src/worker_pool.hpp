@@ -0,0 +1,43 @@
+/*
+Process-wide worker threads for the batch functions of the C interface. A batch is split into blocks of items that
+are claimed with an atomic counter by the calling thread and by as many helpers as it asked for, so concurrent
+batches from different caller threads share the workers.
+*/
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace jac {
+
+class WorkerPool {
+public:
+    static WorkerPool& instance();
+
+    // Number of threads that can work on a batch at once, the calling thread included.
+    std::size_t concurrency() const { return workers_.size() + 1; }
+
+    // Call fn(i) for every i in [0, count) on up to `threads` threads (the caller included) and wait for all of
+    // them. fn must not throw.
+    void parallel_for(std::size_t count, std::size_t threads, const std::function<void(std::size_t)>& fn);
+
+private:
+    struct Batch;
+
+    WorkerPool();
+    void work();
+    static void run(Batch& batch);
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    std::deque<Batch*> queue_;
+    std::vector<std::thread> workers_;
+};
+
+} // namespace jac
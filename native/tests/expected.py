@@ -0,0 +1,35 @@
+'''
+Writes what json.py appends to every byte prefix of the documents in a corpus directory, for test_completer.
+Usage: expected.py corpus_dir out_dir
+out_dir/manifest.txt lists the documents, and out_dir/<name>.expected has one line per prefix length (0 to the size of
+the document in bytes), the suffix json_autocomplete adds to it. A prefix that ends inside a UTF-8 sequence is
+completed like the prefix before that sequence, since it can only be inside a string.
+'''
+
+
+import os
+import sys
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', '..'))
+
+from json_autocomplete.json import json_autocomplete
+
+
+def main(corpus_dir, out_dir):
+    os.makedirs(out_dir, exist_ok=True)
+    names = sorted(name for name in os.listdir(corpus_dir) if name.endswith('.json'))
+    for name in names:
+        with open(os.path.join(corpus_dir, name), 'rb') as f:
+            data = f.read()
+        lines = []
+        for i in range(len(data) + 1):
+            prefix = data[:i].decode('utf-8', 'ignore')
+            lines.append(json_autocomplete(prefix)[len(prefix):])
+        with open(os.path.join(out_dir, name + '.expected'), 'w', encoding='ascii', newline='\n') as f:
+            f.write('\n'.join(lines) + '\n')
+    with open(os.path.join(out_dir, 'manifest.txt'), 'w', newline='\n') as f:
+        f.write(''.join(name + '\n' for name in names))
+
+
+if __name__ == '__main__':
+    main(*sys.argv[1:])
@@ -0,0 +1,180 @@
+// Differential test of the native completer against json.py: every prefix of every document in the corpus must get
+// the suffix json.py appends (as written by expected.py), whether it is fed in one chunk, byte by byte, in random
+// chunks, or completed in a jac_complete_many batch. Inputs that are not JSON prefixes must be rejected.
+// Usage: test_completer corpus_dir expected_dir
+
+#include "json_autocomplete/completer.hpp"
+#include "json_autocomplete/jac.h"
+#include "json_autocomplete/json_grammar.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+int failures = 0;
+
+void check(bool ok, const std::string& what, const std::string& document, std::size_t length) {
+    if (ok)
+        return;
+    if (++failures <= 20)
+        std::fprintf(stderr, "FAIL %s: %s, prefix of %zu bytes\n", what.c_str(), document.c_str(), length);
+}
+
+bool read_file(const std::string& path, std::string& out) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+        return false;
+    std::ostringstream data;
+    data << in.rdbuf();
+    out = data.str();
+    return true;
+}
+
+std::vector<std::string> read_lines(const std::string& path) {
+    std::string data;
+    std::vector<std::string> lines;
+    if (!read_file(path, data))
+        return lines;
+    std::size_t start = 0;
+    for (std::size_t end; (end = data.find('\n', start)) != std::string::npos; start = end + 1)
+        lines.push_back(data.substr(start, end - start));
+    return lines;
+}
+
+void test_document(const std::string& name, const std::string& doc, const std::vector<std::string>& expected) {
+    const std::size_t n = doc.size();
+    if (expected.size() != n + 1) {
+        check(false, "expected file does not match the document", name, n);
+        return;
+    }
+
+    // in one chunk, each prefix on a reused Completer
+    jac::Completer completer;
+    for (std::size_t i = 0; i <= n; ++i) {
+        completer.reset();
+        bool ok = completer.feed(std::string_view(doc).substr(0, i));
+        check(ok && completer.suffix() == expected[i], "one chunk", name, i);
+        check(completer.consumed() == i, "consumed", name, i);
+    }
+
+    // byte by byte, checking the suffix after each byte
+    completer.reset();
+    check(completer.suffix() == expected[0], "byte by byte", name, 0);
+    for (std::size_t i = 0; i < n; ++i) {
+        bool ok = completer.feed(std::string_view(doc).substr(i, 1));
+        check(ok && completer.suffix() == expected[i + 1], "byte by byte", name, i + 1);
+    }
+
+    // random chunks, with a shrink in between
+    std::mt19937 rng(static_cast<unsigned>(n));
+    for (int round = 0; round < 4; ++round) {
+        completer.reset();
+        for (std::size_t i = 0; i < n;) {
+            std::size_t size = 1 + rng() % 16;
+            if (size > n - i)
+                size = n - i;
+            bool ok = completer.feed(std::string_view(doc).substr(i, size));
+            i += size;
+            completer.shrink_to(round);
+            check(ok && completer.suffix() == expected[i], "random chunks", name, i);
+        }
+    }
+
+    // the compile-time grammar
+    for (std::size_t i = 0; i <= n; i += 1 + n / 64) {
+        std::string prefix = doc.substr(0, i);
+        check(jac::grammar::json::json_autocomplete(prefix) == prefix + expected[i], "json_grammar.hpp", name, i);
+    }
+
+    // all prefixes in one batch, on the worker threads
+    std::vector<std::string> prefixes;
+    std::vector<const char*> data;
+    std::vector<std::size_t> lengths;
+    std::size_t capacity = 0;
+    for (std::size_t i = 0; i <= n; ++i)
+        prefixes.push_back(doc.substr(0, i));
+    for (const auto& prefix : prefixes) {
+        data.push_back(prefix.data());
+        lengths.push_back(prefix.size());
+        capacity += JAC_SUFFIX_BOUND(prefix.size());
+    }
+    std::vector<char> out(capacity);
+    std::vector<std::size_t> suffix_lengths(n + 1);
+    std::vector<int> statuses(n + 1, -100);
+    int status = jac_complete_many(n + 1, data.data(), lengths.data(), out.data(), capacity, suffix_lengths.data(),
+                                   statuses.data(), 0);
+    check(status == JAC_OK, "jac_complete_many", name, n);
+    std::size_t offset = 0;
+    for (std::size_t i = 0; i <= n && status == JAC_OK; ++i) {
+        std::string_view suffix(out.data() + offset, suffix_lengths[i]);
+        check(statuses[i] == JAC_OK && suffix == expected[i], "jac_complete_many", name, i);
+        check(suffix_lengths[i] <= JAC_SUFFIX_BOUND(i), "JAC_SUFFIX_BOUND", name, i);
+        offset += JAC_SUFFIX_BOUND(lengths[i]);
+    }
+    status = jac_complete_many(n + 1, data.data(), lengths.data(), out.data(), capacity - 1, suffix_lengths.data(),
+                               statuses.data(), 0);
+    check(status == JAC_ERR_BUFFER, "jac_complete_many with a short buffer", name, n);
+}
+
+void test_invalid() {
+    const char* invalid[] = {"}", "}}", "{]", "[}", "[1,]", "{\"a\" 1", "{\"a\":1,}", "nul ", "tx", "01", "-a", "1.e",
+                             "\"\\x", "\"\\u12g", "[1 2", "{1", "1 2", "\"a\"\""};
+    for (const char* text : invalid) {
+        std::string_view prefix(text);
+        jac::Completer completer;
+        bool ok = completer.feed(prefix);
+        check(!ok && completer.failed() && !completer.feed(" "), "invalid input accepted", text, prefix.size());
+
+        // byte by byte, it must fail at some point, and stay failed
+        completer.reset();
+        ok = true;
+        for (char c : prefix)
+            ok = ok && completer.feed(std::string_view(&c, 1));
+        check(!ok && completer.failed(), "invalid input accepted byte by byte", text, prefix.size());
+
+        const char* data[] = {text};
+        std::size_t lengths[] = {prefix.size()};
+        std::vector<char> out(JAC_SUFFIX_BOUND(prefix.size()));
+        std::size_t suffix_lengths[1];
+        int statuses[1];
+        jac_complete_many(1, data, lengths, out.data(), out.size(), suffix_lengths, statuses, 1);
+        check(statuses[0] == JAC_ERR_SYNTAX, "invalid input accepted by jac_complete_many", text, prefix.size());
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        std::fprintf(stderr, "usage: %s corpus_dir expected_dir\n", argv[0]);
+        return 2;
+    }
+    const std::string corpus = argv[1], expected = argv[2];
+    std::vector<std::string> names = read_lines(expected + "/manifest.txt");
+    if (names.empty()) {
+        std::fprintf(stderr, "no documents in %s/manifest.txt\n", expected.c_str());
+        return 2;
+    }
+    for (const auto& name : names) {
+        std::string doc;
+        if (!read_file(corpus + "/" + name, doc)) {
+            std::fprintf(stderr, "cannot read %s/%s\n", corpus.c_str(), name.c_str());
+            return 2;
+        }
+        test_document(name, doc, read_lines(expected + "/" + name + ".expected"));
+    }
+    test_invalid();
+
+    if (failures) {
+        std::fprintf(stderr, "%d failures\n", failures);
+        return 1;
+    }
+    std::printf("%zu documents, all prefixes match json.py\n", names.size());
+    return 0;
+}
@@ -0,0 +1,39 @@
+'''
+Generates src/powers_of_five.inc, the 128-bit truncated powers of five 5^q for q in [-342, 308] used by the Eisel-Lemire float parser in src/number.cpp.
+Each entry is normalized so that its most significant bit is bit 127, and stored as {high 64 bits, low 64 bits}.
+Negative powers are the reciprocals 2^b / 5^-q, rounded up, as in the fast_float library.
+
+    python native/tools/gen_powers_of_five.py > native/src/powers_of_five.inc
+'''
+
+
+SMALLEST = -342
+LARGEST = 308
+
+
+def power_of_five_128(q):
+    if q >= 0:
+        power5 = 5 ** q
+        while power5 < (1 << 127):
+            power5 *= 2
+        while power5 >= (1 << 128):
+            power5 //= 2
+        return power5
+    power5 = 5 ** -q
+    z = power5.bit_length()
+    b = z + 127 if q >= -27 else 2 * z + 2 * 64
+    c = 2 ** b // power5 + 1
+    while c >= (1 << 128):
+        c //= 2
+    return c
+
+
+def main():
+    print('// Generated by tools/gen_powers_of_five.py, do not edit.')
+    for q in range(SMALLEST, LARGEST + 1):
+        c = power_of_five_128(q)
+        print(f'{{0x{c >> 64:016x}, 0x{c & 0xFFFFFFFFFFFFFFFF:016x}}}, // 5^{q}')
+
+
+if __name__ == '__main__':
+    main()
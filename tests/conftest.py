@@ -0,0 +1,53 @@
+'''
+Shared helpers for the tests: the documents in corpus/, and ways to cut them into prefixes and chunks.
+The reference for everything is json.py: a feature is correct if it agrees with json.loads(json_autocomplete(prefix)) on every prefix.
+'''
+
+
+import functools
+import json
+import os
+import random
+import sys
+
+import pytest
+
+sys.path.insert(0, os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+
+from json_autocomplete import json_autocomplete
+
+
+CORPUS_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), 'corpus')
+CORPUS = sorted(name for name in os.listdir(CORPUS_DIR) if name.endswith('.json'))
+
+
+def load(name):
+    with open(os.path.join(CORPUS_DIR, name), encoding='utf-8', newline='') as f:
+        return f.read()
+
+def prefixes(text):
+    return [text[:i] for i in range(len(text) + 1)]
+
+def chunks(text, seed, max_size=8):
+    '''text cut into random chunks of 1 to max_size characters.'''
+    rng = random.Random(seed)
+    pieces = []
+    i = 0
+    while i < len(text):
+        j = i + rng.randint(1, max_size)
+        pieces.append(text[i:j])
+        i = j
+    return pieces
+
+@functools.lru_cache(maxsize=None)
+def completed(prefix):
+    return json_autocomplete(prefix)
+
+def reference(prefix):
+    '''What every feature is checked against (a fresh object, so it can be changed).'''
+    return json.loads(completed(prefix))
+
+
+@pytest.fixture(params=CORPUS)
+def document(request):
+    return load(request.param)
@@ -0,0 +1,28 @@
+import json
+import random
+
+from conftest import chunks
+from json_autocomplete import Completer, NumericArrays
+
+
+def test_numeric_arrays():
+    rng = random.Random(3)
+    for trial in range(50):
+        vectors = [[rng.choice([1, -2.5, 1e-7, 123456789, 0.1, 3]) for _ in range(rng.randint(0, 30))] for _ in range(3)]
+        document = json.dumps({'a': vectors, 'b': [1, 2]}, indent=rng.choice([None, 1]))
+        arrays = NumericArrays('a.*')
+        completer = Completer(arrays)
+        for chunk in chunks(document, seed=trial, max_size=6):
+            completer.feed(chunk)
+        for i, vector in enumerate(vectors):
+            assert list(arrays[f'a.{i}']) == [float(x) for x in vector]
+        assert 'b' not in arrays
+
+def test_reads_see_every_number():
+    arrays = NumericArrays('v')
+    completer = Completer(arrays)
+    for char in '{"v": [1, 2, 3':
+        completer.feed(char)
+    assert list(arrays['v']) == [1.0, 2.0]
+    completer.feed(', 4, 5, ')
+    assert list(arrays['v']) == [1.0, 2.0, 3.0, 4.0, 5.0]
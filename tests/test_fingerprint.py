@@ -0,0 +1,42 @@
+import hashlib
+
+import pytest
+
+from conftest import chunks, completed
+from json_autocomplete import Completer, RunningHash, Writer
+
+
+def blake2b(text):
+    return hashlib.blake2b(text.encode('utf-8', 'surrogatepass')).hexdigest()
+
+
+def test_completer(document):
+    completer = Completer(digest='blake2b')
+    fed = ''
+    for chunk in chunks(document, seed=2):
+        completer.feed(chunk)
+        fed += chunk
+        assert completer.fingerprint() == blake2b(completed(fed))
+
+@pytest.mark.parametrize('make', [lambda: Completer(digest='blake2b', indent=2), lambda: Completer(digest='blake2b', compact=True), lambda: Writer(digest='blake2b', max_items=3)])
+def test_output_modes(document, make):
+    # the fingerprint is that of the output: what feed() returned so far, plus the suffix
+    stream = make()
+    output = ''
+    for chunk in chunks(document, seed=3):
+        output += stream.feed(chunk)
+        assert stream.fingerprint() == blake2b(output + stream.suffix())
+
+def test_reset():
+    completer = Completer(digest='blake2b')
+    completer.feed('{"a": [1, 2')
+    completer.reset()
+    completer.feed('[tr')
+    assert completer.fingerprint() == blake2b('[true]')
+
+def test_running_hash():
+    running = RunningHash('sha256')
+    running.update('{"a": ')
+    running.update('[1')
+    assert running.fingerprint(']}') == hashlib.sha256(b'{"a": [1]}').hexdigest()
+    assert running.fingerprint('') == hashlib.sha256(b'{"a": [1').hexdigest()
@@ -0,0 +1,75 @@
+import os
+
+import pytest
+
+from conftest import completed, prefixes
+from json_autocomplete import compile_grammar, grammar
+from json_autocomplete.grammar import GrammarError, build
+
+
+JSON = r'''
+# json.py, as a text grammar
+start  = ws value ;
+ws     = [ \n\r\t]* ;
+value  = ( 'null' | string | number | object | array | 'true' | 'false' ) ws ;
+digits = [0-9]+ ;
+number = '-'? ( '0' | [1-9] [0-9]* ) ( '.' digits )? ( [eE] [+\-]? digits )? ;
+hex    = [0-9a-fA-F] ;
+string = '"' ( [^"\\] | '\\' ( ["\\/bfnrt] | 'u' hex hex hex hex ) )* '"' ;
+member = string ws ':' ws value ;
+object = '{' ws ( member ( ',' ws member )* )? '}' ;
+array  = '[' ws ( value ( ',' ws value )* )? ']' ;
+'''
+
+
+def test_json_grammar(document, tmp_path):
+    complete = compile_grammar(JSON, cache=str(tmp_path))
+    start = build(JSON)['start']
+    for prefix in prefixes(document):
+        assert complete(prefix) == completed(prefix), prefix
+        assert start(prefix, 0)[0] == completed(prefix), prefix
+
+def test_start_rule():
+    pair = compile_grammar('''
+        pair   = '(' number ',' number ')' ;
+        number = '-'? [0-9]+ ;
+    ''', cache=False)
+    assert pair('(4') == '(4,0)'
+    assert pair('(-') == '(-0,0)'
+    assert pair('') == '(0,0)'
+    number = compile_grammar("pair = '(' number ')' ; number = '-'? [0-9]+ ;", start='number', cache=False)
+    assert number('-') == '-0'
+    with pytest.raises(GrammarError):
+        compile_grammar("a = 'x' ;", start='b', cache=False)
+
+def test_cache(tmp_path, monkeypatch):
+    compile_grammar(JSON, cache=str(tmp_path))
+    files = os.listdir(tmp_path)
+    assert len(files) == 1
+    # a cached grammar is neither parsed nor generated again
+    def fail(text):
+        raise AssertionError('not cached')
+    monkeypatch.setattr(grammar, 'generate', fail)
+    monkeypatch.setattr(grammar, 'parse_grammar', fail)
+    assert compile_grammar(JSON, cache=str(tmp_path))('[tr') == '[true]'
+    monkeypatch.undo()
+
+    # another grammar gets another file, and a damaged file is replaced
+    compile_grammar("a = 'x' ;", cache=str(tmp_path))
+    assert len(os.listdir(tmp_path)) == 2
+    path = os.path.join(tmp_path, files[0])
+    with open(path, 'wb') as f:
+        f.write(b'\0garbage')
+    assert compile_grammar(JSON, cache=str(tmp_path))('[tr') == '[true]'
+    assert compile_grammar(JSON, cache=str(tmp_path))('{"a') == '{"a":null}'
+
+def test_cache_dir(tmp_path, monkeypatch):
+    monkeypatch.setenv('JSON_AUTOCOMPLETE_CACHE', str(tmp_path / 'cache'))
+    assert grammar.cache_dir() == str(tmp_path / 'cache')
+    compile_grammar("a = 'x' ;")
+    assert len(os.listdir(tmp_path / 'cache')) == 1
+
+@pytest.mark.parametrize('text', ["a = b ;", "a = 'x' a ;", "a = ;", "a = 'x'", "a = [] ;", "a = 'x' ; a = 'y' ;", "a = '' ;", "", "a = 'x\\", "a = 'x\\u12", "a = '\\u12g4' ;"])
+def test_errors(text):
+    with pytest.raises(GrammarError):
+        compile_grammar(text, cache=False)
@@ -0,0 +1,57 @@
+import json
+
+import pytest
+
+from conftest import chunks, completed, reference
+from json_autocomplete import Completer, json_autocomplete
+
+
+def test_suffix(document):
+    completer = Completer()
+    fed = ''
+    for chunk in chunks(document, seed=7):
+        completer.feed(chunk)
+        fed += chunk
+        assert fed + completer.suffix() == completed(fed)
+
+def check_output(document, options):
+    completer = Completer(**options)
+    output = ''
+    fed = ''
+    for chunk in chunks(document, seed=8):
+        output += completer.feed(chunk)
+        fed += chunk
+        assert json.loads(output + completer.suffix()) == reference(fed), fed
+    assert output + completer.suffix() == json_autocomplete(document, **options)
+
+def test_compact_stream(document):
+    check_output(document, {'compact': True})
+
+def test_compact():
+    assert json_autocomplete('{ "a" : [ 1 , "b c', compact=True) == '{"a":[1,"b c"]}'
+
+@pytest.mark.parametrize('indent', [2, 0])
+def test_indent_stream(document, indent):
+    check_output(document, {'indent': indent})
+
+def test_indent():
+    assert json_autocomplete('{"a": [1, {"b": nu', indent=2) == '{\n  "a": [\n    1,\n    {\n      "b": null\n    }\n  ]\n}'
+
+@pytest.mark.parametrize('text', ['}', '{]', '[1,]', '{"a" 1', 'tx', '01', '[1 2'])
+def test_invalid(text):
+    completer = Completer()
+    with pytest.raises(ValueError):
+        completer.feed(text)
+    with pytest.raises(ValueError):
+        completer.suffix()
+    completer.reset()
+    completer.feed('[')
+    assert completer.suffix() == ']'
+
+def test_close_events_without_handler():
+    completer = Completer()
+    completer.feed('{"a": [1')
+    with pytest.raises(ValueError):
+        completer.close_events()
+    completer.feed(']}')
+    assert completer.suffix() == ''
@@ -0,0 +1,16 @@
+from conftest import prefixes, reference
+from json_autocomplete import loads_partial_lazy
+
+
+def test_lazy(document):
+    for prefix in prefixes(document)[::3]:
+        assert loads_partial_lazy(prefix) == reference(prefix), prefix
+
+def test_lazy_access():
+    value = loads_partial_lazy('{"a": [1, 2.5, "x", {"b": null}], "c": tr')
+    assert value['c'] is True
+    assert len(value) == 2 and list(value) == ['a', 'c'] and 'a' in value
+    a = value['a']
+    assert a[-1]['b'] is None and a[1:3] == [2.5, 'x'] and len(a) == 4
+    assert a is value['a'] # cached
+    assert a.raw() == '[1, 2.5, "x", {"b": null}]'
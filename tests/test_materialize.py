@@ -0,0 +1,72 @@
+import base64
+import io
+import json
+
+from conftest import chunks, prefixes, reference
+from json_autocomplete import Builder, Completer, KeyTable, Rope, Sink, json_default, loads_partial, to_plain
+
+
+def test_loads_partial(document):
+    for prefix in prefixes(document):
+        assert loads_partial(prefix) == reference(prefix), prefix
+
+def test_loads_partial_private_keys():
+    keys = KeyTable(2)
+    document = '{"a": 1, "b": {"c": [1, {"a": 2}]}, "d'
+    assert loads_partial(document, keys=keys) == loads_partial(document, keys=None) == {'a': 1, 'b': {'c': [1, {'a': 2}]}, 'd': None}
+    value = loads_partial('[{"name": 1}, {"name": 2}]')
+    assert next(iter(value[0])) is next(iter(value[1])) # interned
+
+def test_streamed(document):
+    builder = Builder()
+    completer = Completer(builder)
+    for chunk in chunks(document, seed=4):
+        completer.feed(chunk)
+    completer.close_events()
+    assert builder.value == reference(document)
+
+def test_ropes():
+    builder = Builder(ropes=True)
+    completer = Completer(builder)
+    completer.feed('{"a": ["hel')
+    completer.feed('lo wor')
+    rope = builder.value['a'][0]
+    assert isinstance(rope, Rope) and rope == 'hello wor' and len(rope) == 9 and rope.upper() == 'HELLO WOR'
+    assert json.dumps(builder.value, default=json_default) == '{"a": ["hello wor"]}'
+    plain = to_plain(builder.value)
+    assert plain == {'a': ['hello wor']} and type(plain['a'][0]) is str
+    completer.feed('ld"]}')
+    assert type(builder.value['a'][0]) is str and builder.value == {'a': ['hello world']}
+
+
+def test_sink_file():
+    data = bytes(range(256)) * 10
+    document = json.dumps({'name': 'x', 'files': [{'data': base64.b64encode(data).decode()}]})
+    out = io.BytesIO()
+    builder = Builder(sinks={'files.*.data': Sink(out, base64=True, placeholder='<file>')})
+    completer = Completer(builder)
+    for chunk in chunks(document, seed=5, max_size=30):
+        completer.feed(chunk)
+    assert out.getvalue() == data
+    assert builder.value == {'name': 'x', 'files': [{'data': '<file>'}]}
+
+def test_sink_truncated_base64():
+    for text, data in [('QUJDR', b'ABC'), ('QUJDRA', b'ABCD'), ('QUJDRE', b'ABCD'), ('QUJDREU', b'ABCDE')]:
+        out = io.BytesIO()
+        completer = Completer(Builder(sinks={'f': Sink(out, base64=True)}))
+        completer.feed('{"f": "' + text)
+        completer.close_events()
+        assert out.getvalue() == data
+
+def test_sink_preview_while_streaming():
+    pieces = []
+    builder = Builder(sinks={'d': Sink(pieces.append, preview=5)})
+    completer = Completer(builder)
+    document = '{"d": "abcdefghij", "e": 1}'
+    values = []
+    for char in document:
+        completer.feed(char)
+        values.append(builder.value.get('d'))
+    assert values[7:13] == ['a', 'ab', 'abc', 'abcd', 'abcde', 'abcde…']
+    assert builder.value == {'d': 'abcde…', 'e': 1}
+    assert ''.join(pieces) == 'abcdefghij'
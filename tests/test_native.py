@@ -0,0 +1,83 @@
+import pytest
+
+from conftest import chunks, completed, prefixes
+from json_autocomplete import native
+from json_autocomplete.native import Stream, complete_into, complete_many, decode_number, decode_numbers, feed_many
+
+
+# with the library if it is loaded (see $JSON_AUTOCOMPLETE_LIB), and always without
+@pytest.fixture(params=['native', 'fallback'])
+def backend(request, monkeypatch):
+    if request.param == 'native':
+        if not native.available:
+            pytest.skip('libjson_autocomplete is not loaded')
+    else:
+        monkeypatch.setattr(native, '_lib', None)
+    return request.param
+
+INVALID = ['}', '}}', '{]', '[1,]', '{"a" 1', 'tx', '01', '[1 2']
+
+
+def test_complete_many(backend, document):
+    batch = prefixes(document)
+    assert complete_many(batch) == [completed(p) for p in batch]
+    assert complete_many([p.encode() for p in batch[::7]]) == [completed(p).encode() for p in batch[::7]]
+
+def test_stream(backend, document):
+    with Stream() as stream:
+        fed = ''
+        for chunk in chunks(document, seed=6):
+            stream.feed(chunk)
+            fed += chunk
+            assert fed + stream.suffix() == completed(fed)
+
+def test_stream_bytes_split_inside_a_character(backend):
+    with Stream() as stream:
+        stream.feed(b'["\xc3')
+        stream.feed(b'\xa9')
+        assert stream.suffix() == '"]'
+
+def test_feed_many(backend):
+    streams = [Stream() for _ in range(3)]
+    feed_many(streams, ['[1', '{"b"', 'tr'])
+    assert [s.suffix() for s in streams] == [']', ':null}', 'ue']
+
+@pytest.mark.parametrize('text', INVALID)
+def test_invalid_input(backend, text):
+    with pytest.raises(ValueError):
+        complete_many([text])
+    with pytest.raises(ValueError):
+        stream = Stream()
+        stream.feed(text)
+        stream.suffix()
+
+@pytest.mark.parametrize('text', INVALID)
+def test_invalid_input_into_buffer(backend, text):
+    with pytest.raises(ValueError):
+        complete_into(text, bytearray())
+
+def test_complete_into(backend):
+    buffer = bytearray()
+    n = complete_into('{"a": [1, "é', buffer, offset=2)
+    assert buffer[2:2 + n].decode() == '{"a": [1, "é"]}'
+    # a fixed buffer that is too small is left untouched
+    fixed = memoryview(bytearray(12))
+    with pytest.raises(ValueError):
+        complete_into('{"a": [1, [2', fixed)
+    assert bytes(fixed) == bytes(12)
+
+def test_suffix_into(backend):
+    with Stream() as stream:
+        stream.feed('{"a": [tr')
+        buffer = bytearray(b'xy')
+        assert stream.suffix_into(buffer, 2) == 4
+        assert buffer[:6] == b'xyue]}'
+
+def test_decode_numbers(backend):
+    texts = ['0', '-12', '2.5', '1e3', '-', '2.', '1e', '123456789012345678901234567890']
+    assert decode_numbers(texts) == [0, -12, 2.5, 1000.0, 0, 2.0, 1.0, 123456789012345678901234567890]
+    decoded = [decode_number(t) for t in texts]
+    assert decoded == [0, -12, 2.5, 1000.0, 0, 2.0, 1.0, 123456789012345678901234567890]
+    assert [type(x) for x in decoded] == [int, int, float, float, int, float, float, int]
+    with pytest.raises(ValueError):
+        decode_number('1x')
@@ -0,0 +1,36 @@
+import json
+
+from conftest import chunks
+from json_autocomplete import Completer
+from json_autocomplete.tape import ARRAY, OBJECT
+
+
+def index(document, seed=None):
+    completer = Completer(tape=True)
+    for chunk in ([document] if seed is None else chunks(document, seed)):
+        completer.feed(chunk)
+    completer.finish()
+    return completer.tape
+
+def decode(tape, text, i):
+    '''The value at tape entry i, built from the tape alone.'''
+    kind = tape.type(i)
+    if kind == OBJECT:
+        children = list(tape.children(i))
+        return {tape.decode(text, children[k]): decode(tape, text, children[k + 1]) for k in range(0, len(children), 2)}
+    if kind == ARRAY:
+        return [decode(tape, text, child) for child in tape.children(i)]
+    return tape.decode(text, i)
+
+
+def test_tape(document):
+    assert decode(index(document), document, 0) == json.loads(document)
+    assert decode(index(document, seed=9), document, 0) == json.loads(document)
+
+def test_raw():
+    text = ' {"a": [1, 2.5, "x"], "b": {"c": null}} '
+    tape = index(text)
+    a, b = list(tape.children(0))[1::2]
+    assert tape.raw(text, 0) == text.strip()
+    assert tape.raw(text, a) == '[1, 2.5, "x"]'
+    assert tape.raw(text, b) == '{"c": null}'
@@ -0,0 +1,99 @@
+import json
+import struct
+
+from conftest import chunks, prefixes, reference
+from json_autocomplete import MessagePackWriter
+
+
+def unpack(data, i=0):
+    '''A minimal MessagePack decoder for the types MessagePackWriter emits. Returns (value, end).'''
+    t = data[i]
+    if t < 0x80:
+        return t, i + 1
+    if t >= 0xe0:
+        return t - 0x100, i + 1
+    if t <= 0x8f:
+        return unpack_map(data, i + 1, t & 0x0f)
+    if t <= 0x9f:
+        return unpack_array(data, i + 1, t & 0x0f)
+    if t <= 0xbf:
+        return unpack_str(data, i + 1, t & 0x1f)
+    if t in (0xc0, 0xc2, 0xc3):
+        return {0xc0: None, 0xc2: False, 0xc3: True}[t], i + 1
+    fixed = {0xcb: '>d', 0xcc: '>B', 0xcd: '>H', 0xce: '>I', 0xcf: '>Q', 0xd0: '>b', 0xd1: '>h', 0xd2: '>i', 0xd3: '>q'}
+    if t in fixed:
+        size = struct.calcsize(fixed[t])
+        return struct.unpack(fixed[t], data[i + 1:i + 1 + size])[0], i + 1 + size
+    sized = {0xd9: ('>B', unpack_str), 0xda: ('>H', unpack_str), 0xdb: ('>I', unpack_str), 0xdc: ('>H', unpack_array), 0xdd: ('>I', unpack_array), 0xde: ('>H', unpack_map), 0xdf: ('>I', unpack_map)}
+    fmt, unpack_body = sized[t]
+    size = struct.calcsize(fmt)
+    return unpack_body(data, i + 1 + size, struct.unpack(fmt, data[i + 1:i + 1 + size])[0])
+
+def unpack_str(data, i, n):
+    return data[i:i + n].decode('utf-8', 'surrogatepass'), i + n
+
+def unpack_array(data, i, n):
+    items = []
+    for _ in range(n):
+        item, i = unpack(data, i)
+        items.append(item)
+    return items, i
+
+def unpack_map(data, i, n):
+    members = {}
+    for _ in range(n):
+        key, i = unpack(data, i)
+        assert key not in members, f'duplicate key {key!r}'
+        members[key], i = unpack(data, i)
+    return members, i
+
+def loads(data):
+    value, end = unpack(data)
+    assert end == len(data)
+    return value
+
+def as_msgpack(value):
+    '''Integers beyond 64 bits are encoded as floats.'''
+    if isinstance(value, int) and not isinstance(value, bool) and not -2**63 <= value < 2**64:
+        return float(value)
+    if isinstance(value, list):
+        return [as_msgpack(v) for v in value]
+    if isinstance(value, dict):
+        return {k: as_msgpack(v) for k, v in value.items()}
+    return value
+
+
+def test_every_prefix(document):
+    for prefix in prefixes(document):
+        writer = MessagePackWriter()
+        writer.feed(prefix)
+        assert loads(writer.packed()) == as_msgpack(reference(prefix)), prefix
+
+def test_chunked(document):
+    writer = MessagePackWriter()
+    fed = ''
+    for chunk in chunks(document, seed=len(document)):
+        writer.feed(chunk)
+        fed += chunk
+        assert loads(writer.packed()) == as_msgpack(reference(fed)), fed
+        assert writer.packed() == writer.packed()
+
+def test_large_containers():
+    document = json.dumps({'s': 'x' * 70000, 'l': list(range(70000)), 'm': {str(i): i for i in range(20)}, 'n': [2**40, -2**63, 2**70, 1.5]})
+    writer = MessagePackWriter()
+    for chunk in chunks(document, seed=1, max_size=5000):
+        writer.feed(chunk)
+    assert loads(writer.packed()) == as_msgpack(json.loads(document))
+
+def test_duplicate_keys():
+    # like json.loads: the first occurrence's position, the last occurrence's value
+    for text in ['{"1":1,"2":2,"1', '{"1":1,"2":2,"1":3}', '{"1":1,"2":2,"1":[3,', '{"a":{"1":1,"1":2},"a']:
+        writer = MessagePackWriter()
+        writer.feed(text)
+        assert loads(writer.packed()) == reference(text)
+        assert list(loads(writer.packed())) == list(reference(text))
+    writer = MessagePackWriter()
+    text = '{"1":1,"2":2,"1":3,"4":[5]}'
+    for i, char in enumerate(text):
+        writer.feed(char)
+        assert loads(writer.packed()) == reference(text[:i + 1])
@@ -0,0 +1,101 @@
+import json
+
+import pytest
+
+from conftest import prefixes, reference
+from json_autocomplete import Writer
+from json_autocomplete.paths import PathSet
+
+
+def redacted(value, path, paths, keys, placeholder):
+    if paths.match(path) or (path and path[-1] in keys and isinstance(path[-1], str)):
+        return placeholder
+    if isinstance(value, dict):
+        return {k: redacted(v, path + [k], paths, keys, placeholder) for k, v in value.items()}
+    if isinstance(value, list):
+        return [redacted(v, path + [i], paths, keys, placeholder) for i, v in enumerate(value)]
+    return value
+
+
+REDACTIONS = [
+    (['users.*.ssn.*'], ()),
+    (['users.0.embedding.1', 'nested.0.0.0.1'], ()),
+    (['users.*.ssn'], ['email']),
+    ([], ['name', 'value']),
+    ([''], ()),
+]
+
+@pytest.mark.parametrize('redact, redact_keys', REDACTIONS)
+def test_redact_in_one_chunk(document, redact, redact_keys):
+    paths = PathSet(redact)
+    for prefix in prefixes(document):
+        writer = Writer(redact=redact, redact_keys=redact_keys)
+        output = writer.feed(prefix) + writer.suffix()
+        assert json.loads(output) == redacted(reference(prefix), [], paths, redact_keys, '[REDACTED]'), prefix
+
+@pytest.mark.parametrize('redact, redact_keys', REDACTIONS)
+def test_redact_char_by_char(document, redact, redact_keys):
+    paths = PathSet(redact)
+    writer = Writer(redact=redact, redact_keys=redact_keys)
+    output = ''
+    for i, char in enumerate(document):
+        output += writer.feed(char)
+        prefix = document[:i + 1]
+        assert json.loads(output + writer.suffix()) == redacted(reference(prefix), [], paths, redact_keys, '[REDACTED]'), prefix
+
+def test_redact_number_runs():
+    # a run of numbers in one chunk takes a fast path that must still redact
+    writer = Writer(redact=['a.1'])
+    assert writer.feed('{"a": [1, 2, 3, 4]}') == '{"a":[1,"[REDACTED]",3,4]}'
+    writer = Writer(redact=['ssn.*'])
+    assert writer.feed('{"ssn": [1, 2, 3], "n": [4, 5]}') == '{"ssn":["[REDACTED]","[REDACTED]","[REDACTED]"],"n":[4,5]}'
+
+
+def previewed(value, max_items, max_string, max_depth, depth=0):
+    if isinstance(value, (list, dict)) and max_depth is not None and depth >= max_depth:
+        return '…'
+    if isinstance(value, list):
+        items = [previewed(v, max_items, max_string, max_depth, depth + 1) for v in value[:max_items]]
+        return items + ['…'] if max_items is not None and len(value) > max_items else items
+    if isinstance(value, dict):
+        return {k: previewed(v, max_items, max_string, max_depth, depth + 1) for k, v in value.items()}
+    if isinstance(value, str) and max_string is not None and len(value) > max_string:
+        return value[:max_string] + '…'
+    return value
+
+@pytest.mark.parametrize('max_items, max_string, max_depth', [(None, None, None), (3, 4, 2), (0, 0, 0), (2, None, None), (None, 5, None), (None, None, 1)])
+def test_preview(document, max_items, max_string, max_depth):
+    writer = Writer(max_items, max_string, max_depth)
+    output = ''
+    for i, char in enumerate(document):
+        output += writer.feed(char)
+        prefix = document[:i + 1]
+        assert json.loads(output + writer.suffix()) == previewed(reference(prefix), max_items, max_string, max_depth), prefix
+
+def test_preview_output():
+    writer = Writer(max_items=2, max_string=3, max_depth=2)
+    output = writer.feed('{"a": [1, 2, 3, 4], "b": "hello", "c": {"d": {"e": 1}}, "f": [1')
+    assert output + writer.suffix() == '{"a":[1,2,"…"],"b":"hel…","c":{"d":"…"},"f":[1]}'
+
+
+DROP = object()
+
+def selected(value, paths, path):
+    if paths.match(path):
+        return value
+    if isinstance(value, dict) and paths.leads_to(path):
+        members = {k: selected(v, paths, path + [k]) for k, v in value.items()}
+        return {k: v for k, v in members.items() if v is not DROP}
+    if isinstance(value, list) and paths.leads_to(path):
+        return [v for v in (selected(v, paths, path + [i]) for i, v in enumerate(value)) if v is not DROP]
+    return DROP if path else None
+
+@pytest.mark.parametrize('select', [['menu'], ['menu.popup.menuitem.1.value', 'users.1'], ['*.*'], ['users.*.name'], ['nope.x'], [''], ['*.0']])
+def test_select(document, select):
+    paths = PathSet(select)
+    writer = Writer(select=select)
+    output = ''
+    for fed in range(0, len(document), 7):
+        output += writer.feed(document[fed:fed + 7])
+        prefix = document[:fed + 7]
+        assert json.loads(output + writer.suffix()) == selected(reference(prefix), paths, []), prefix